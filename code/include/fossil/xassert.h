@@ -23,8 +23,8 @@ extern "C"
 // ----------------------------------------------------------------
 // Memory assertions
 // ----------------------------------------------------------------
-#define TEST_ASSERT_EQUAL_MEMORY(actual, expected, size)     TEST_ASSERT(memcmp(actual, expected, size) != 0, "Expectation for memory equality not met")
-#define TEST_ASSERT_NOT_EQUAL_MEMORY(actual, expected, size) TEST_ASSERT(memcmp(actual, expected, size) == 0, "Expectation for memory inequality not met")
+#define TEST_ASSERT_EQUAL_MEMORY(actual, expected, size)     TEST_ASSERT(memcmp(actual, expected, size) == 0, "Expectation for memory equality not met")
+#define TEST_ASSERT_NOT_EQUAL_MEMORY(actual, expected, size) TEST_ASSERT(memcmp(actual, expected, size) != 0, "Expectation for memory inequality not met")
 #define TEST_ASSERT_CONTAINS_MEMORY(haystack, needle, haystackSize, needleSize) \
 xbool found = xfalse; \
 for (size_t i = 0; i <= (haystackSize - needleSize); i++) { \
@@ -33,7 +33,7 @@ for (size_t i = 0; i <= (haystackSize - needleSize); i++) { \
         break; \
     } \
 } \
-TEST_ASSERT(!found, "Memory contains assertion failed");
+TEST_ASSERT(found, "Memory contains assertion failed");
 
 #define TEST_ASSERT_NOT_CONTAINS_MEMORY(haystack, needle, haystackSize, needleSize) \
 xbool found = xfalse; \
@@ -43,7 +43,7 @@ for (size_t i = 0; i <= (haystackSize - needleSize); i++) { \
         break; \
     } \
 } \
-TEST_ASSERT(found, "Memory not contains assertion failed");
+TEST_ASSERT(!found, "Memory not contains assertion failed");
 
 #define TEST_ASSERT_COPIED_MEMORY(dest, source, size)     TEST_ASSERT((memcmp(dest, source, size) == 0), "Memory copy check failed");
 #define TEST_ASSERT_NOT_COPIED_MEMORY(dest, source, size) TEST_ASSERT((memcmp(dest, source, size) != 0), "Memory not copied check failed");
@@ -55,19 +55,19 @@ TEST_ASSERT(found, "Memory not contains assertion failed");
 #define TEST_ASSERT_NOT_EQUAL(actual, expected) TEST_ASSERT((xbool)(actual) != (xbool)(expected), "Expectation for inequality not met")
 #define TEST_ASSERT_LESS(actual, expected)      TEST_ASSERT((xbool)(actual) <  (xbool)(expected), "Expectation for less than not met")
 #define TEST_ASSERT_GREATER(actual, expected)   TEST_ASSERT((xbool)(actual) >  (xbool)(expected), "Expectation for greater than not met")
-#define TEST_ASSERT_UNLESS(expression)          TEST_ASSERT((expression), "Expectation not met")
+#define TEST_ASSERT_UNLESS(expression)          TEST_ASSERT(!(expression), "Expectation not met")
 #define TEST_ASSERT_TRUE(expression)            TEST_ASSERT((expression), "Expectation for xtrue not met")
 #define TEST_ASSERT_FALSE(expression)           TEST_ASSERT(!(expression), "Expectation for xfalse not met")
-#define TEST_ASSERT_MSG(expression, message)    TEST_ASSERT(!(expression), message)
+#define TEST_ASSERT_MSG(expression, message)    TEST_ASSERT((expression), message)
 
 #define TEST_ASSERT_EQUAL_BOOL(actual, expected)     TEST_ASSERT((xbool)(actual) == (xbool)(expected), "Expectation for equality not met")
 #define TEST_ASSERT_NOT_EQUAL_BOOL(actual, expected) TEST_ASSERT((xbool)(actual) != (xbool)(expected), "Expectation for inequality not met")
 #define TEST_ASSERT_LESS_BOOL(actual, expected)      TEST_ASSERT((xbool)(actual) <  (xbool)(expected), "Expectation for less than not met")
 #define TEST_ASSERT_GREATER_BOOL(actual, expected)   TEST_ASSERT((xbool)(actual) >  (xbool)(expected), "Expectation for greater than not met")
-#define TEST_ASSERT_UNLESS_BOOL(expression)          TEST_ASSERT((expression), "Expectation not met")
+#define TEST_ASSERT_UNLESS_BOOL(expression)          TEST_ASSERT(!(expression), "Expectation not met")
 #define TEST_ASSERT_TRUE_BOOL(expression)            TEST_ASSERT((expression), "Expectation for xtrue not met")
 #define TEST_ASSERT_FALSE_BOOL(expression)           TEST_ASSERT(!(expression), "Expectation for xfalse not met")
-#define TEST_ASSERT_MSG_BOOL(expression, message)    TEST_ASSERT(!(expression), message)
+#define TEST_ASSERT_MSG_BOOL(expression, message)    TEST_ASSERT((expression), message)
 
 // ----------------------------------------------------------------
 // Enum assertions
@@ -261,7 +261,7 @@ TEST_ASSERT(found, "Memory not contains assertion failed");
 // Float assertions
 // ----------------------------------------------------------------
 #define TEST_ASSERT_FLOAT_EQUAL(actual, expected)         TEST_ASSERT(fabs((float)(actual) -  (float)(expected)) < XTEST_FLOAT_EPSILON, "Floating-point value not equal within epsilon")
-#define TEST_ASSERT_FLOAT_NOT_EQUAL(actual, expected)     TEST_ASSERT(fabs((float)(actual) -  (float)(expected)) <= XTEST_FLOAT_EPSILON, "Floating-point value equal within epsilon")
+#define TEST_ASSERT_FLOAT_NOT_EQUAL(actual, expected)     TEST_ASSERT(fabs((float)(actual) -  (float)(expected)) > XTEST_FLOAT_EPSILON, "Floating-point value equal within epsilon")
 #define TEST_ASSERT_FLOAT_LESS(actual, expected)          TEST_ASSERT((float)(actual)      <  (float)(expected),   "Floating-point value not less")
 #define TEST_ASSERT_FLOAT_GREATER(actual, expected)       TEST_ASSERT((float)(actual)      >  (float)(expected),   "Floating-point value not greater")
 #define TEST_ASSERT_FLOAT_GREATER_EQUAL(actual, expected) TEST_ASSERT((float)(actual)      >= (float)(expected),   "Floating-point value not greater or equal")
@@ -281,7 +281,7 @@ TEST_ASSERT(found, "Memory not contains assertion failed");
 // Double assertions
 // ----------------------------------------------------------------
 #define TEST_ASSERT_DOUBLE_EQUAL(actual, expected)         TEST_ASSERT(fabs((double)(actual) - (double)(expected)) <  XTEST_DOUBLE_EPSILON, "Double-precision value not equal within epsilon")
-#define TEST_ASSERT_DOUBLE_NOT_EQUAL(actual, expected)     TEST_ASSERT(fabs((double)(actual) - (double)(expected)) <= XTEST_DOUBLE_EPSILON, "Double-precision value equal within epsilon")
+#define TEST_ASSERT_DOUBLE_NOT_EQUAL(actual, expected)     TEST_ASSERT(fabs((double)(actual) - (double)(expected)) > XTEST_DOUBLE_EPSILON, "Double-precision value equal within epsilon")
 #define TEST_ASSERT_DOUBLE_LESS(actual, expected)          TEST_ASSERT((double)(actual) <  (double)(expected), "Double-precision value not less")
 #define TEST_ASSERT_DOUBLE_GREATER(actual, expected)       TEST_ASSERT((double)(actual) >  (double)(expected), "Double-precision value not greater")
 #define TEST_ASSERT_DOUBLE_GREATER_EQUAL(actual, expected) TEST_ASSERT((double)(actual) >= (double)(expected), "Double-precision value not greater or equal")
@@ -334,8 +334,8 @@ TEST_ASSERT(found, "Memory not contains assertion failed");
 #define TEST_ASSERT_NOT_CONTAINS_SUBSTRING_STRING(string, substring) TEST_ASSERT(strstr((string), (substring)) == xnullptrptr, "Substring found")
 #define TEST_ASSERT_STARTS_WITH_STRING(string, prefix) TEST_ASSERT(strncmp((string), (prefix), strlen(prefix)) == 0, "String doesn't start with the prefix")
 #define TEST_ASSERT_ENDS_WITH_STRING(string, suffix) TEST_ASSERT(strstr((string), (suffix) != xnullptrptr && (strlen(string) - strlen(suffix)) == (strstr(string, suffix) - string)), "String doesn't end with the suffix")
-#define TEST_ASSERT_EQUAL_CASE_INSENSITIVE_STRING(actual, expected) TEST_ASSERT(strcmp((actual), (expected)) == 0, "Case-insensitive string equality expectation not met")
-#define TEST_ASSERT_NOT_EQUAL_CASE_INSENSITIVE_STRING(actual, expected) TEST_ASSERT(strcmp((actual), (expected)) != 0, "Case-insensitive string inequality expectation not met")
+#define TEST_ASSERT_EQUAL_CASE_INSENSITIVE_STRING(actual, expected) TEST_ASSERT(xstrcasecmp((actual), (expected)) == 0, "Case-insensitive string equality expectation not met")
+#define TEST_ASSERT_NOT_EQUAL_CASE_INSENSITIVE_STRING(actual, expected) TEST_ASSERT(xstrcasecmp((actual), (expected)) != 0, "Case-insensitive string inequality expectation not met")
 
 #define TEST_ASSERT_EQUAL_CSTRING(actual, expected) TEST_ASSERT(strcmp((actual), (expected)) == 0, "String equality expectation not met")
 #define TEST_ASSERT_NOT_EQUAL_CSTRING(actual, expected) TEST_ASSERT(strcmp((actual), (expected)) != 0, "String inequality expectation not met")
@@ -343,9 +343,9 @@ TEST_ASSERT(found, "Memory not contains assertion failed");
 #define TEST_ASSERT_CONTAINS_SUBSTRING_CSTRING(string, substring) TEST_ASSERT(strstr((string), (substring)) != xnullptr, "Substring not found")
 #define TEST_ASSERT_NOT_CONTAINS_SUBSTRING_CSTRING(string, substring) TEST_ASSERT(strstr((string), (substring)) == xnullptr, "Substring found")
 #define TEST_ASSERT_STARTS_WITH_CSTRING(string, prefix) TEST_ASSERT(strncmp((string), (prefix), strlen(prefix)) == 0, "String doesn't start with the prefix")
-#define TEST_ASSERT_ENDS_WITH_CSTRING(string, suffix) TEST_ASSERT((strstr(string, suffix) != xnullptr && strlen(string) >= strlen(suffix) && strcmp(string + strlen(string) - strlen(suffix), suffix)), "String doesn't end with the suffix")
-#define TEST_ASSERT_EQUAL_CASE_INSENSITIVE_CSTRING(actual, expected) TEST_ASSERT(strcmp((actual), (expected)) == 0, "Case-insensitive string equality expectation not met")
-#define TEST_ASSERT_NOT_EQUAL_CASE_INSENSITIVE_CSTRING(actual, expected) TEST_ASSERT(strcmp((actual), (expected)) != 0, "Case-insensitive string inequality expectation not met")
+#define TEST_ASSERT_ENDS_WITH_CSTRING(string, suffix) TEST_ASSERT((strstr(string, suffix) != xnullptr && strlen(string) >= strlen(suffix) && strcmp(string + strlen(string) - strlen(suffix), suffix) == 0), "String doesn't end with the suffix")
+#define TEST_ASSERT_EQUAL_CASE_INSENSITIVE_CSTRING(actual, expected) TEST_ASSERT(xstrcasecmp((actual), (expected)) == 0, "Case-insensitive string equality expectation not met")
+#define TEST_ASSERT_NOT_EQUAL_CASE_INSENSITIVE_CSTRING(actual, expected) TEST_ASSERT(xstrcasecmp((actual), (expected)) != 0, "Case-insensitive string inequality expectation not met")
 #else
 #define TEST_ASSERT_EQUAL_CSTRING(actual, expected) TEST_ASSERT(strcmp((actual), (expected)) == 0, "String equality expectation not met")
 #define TEST_ASSERT_NOT_EQUAL_CSTRING(actual, expected) TEST_ASSERT(strcmp((actual), (expected)) != 0, "String inequality expectation not met")
@@ -353,9 +353,9 @@ TEST_ASSERT(found, "Memory not contains assertion failed");
 #define TEST_ASSERT_CONTAINS_SUBSTRING_CSTRING(string, substring) TEST_ASSERT(strstr((string), (substring)) != xnullptr, "Substring not found")
 #define TEST_ASSERT_NOT_CONTAINS_SUBSTRING_CSTRING(string, substring) TEST_ASSERT(strstr((string), (substring)) == xnullptr, "Substring found")
 #define TEST_ASSERT_STARTS_WITH_CSTRING(string, prefix) TEST_ASSERT(strncmp((string), (prefix), strlen(prefix)) == 0, "String doesn't start with the prefix")
-#define TEST_ASSERT_ENDS_WITH_CSTRING(string, suffix) TEST_ASSERT((strstr(string, suffix) != xnullptr && strlen(string) >= strlen(suffix) && strcmp(string + strlen(string) - strlen(suffix), suffix)), "String doesn't end with the suffix")
-#define TEST_ASSERT_EQUAL_CASE_INSENSITIVE_CSTRING(actual, expected) TEST_ASSERT(strcmp((actual), (expected)) == 0, "Case-insensitive string equality expectation not met")
-#define TEST_ASSERT_NOT_EQUAL_CASE_INSENSITIVE_CSTRING(actual, expected) TEST_ASSERT(strcmp((actual), (expected)) != 0, "Case-insensitive string inequality expectation not met")
+#define TEST_ASSERT_ENDS_WITH_CSTRING(string, suffix) TEST_ASSERT((strstr(string, suffix) != xnullptr && strlen(string) >= strlen(suffix) && strcmp(string + strlen(string) - strlen(suffix), suffix) == 0), "String doesn't end with the suffix")
+#define TEST_ASSERT_EQUAL_CASE_INSENSITIVE_CSTRING(actual, expected) TEST_ASSERT(xstrcasecmp((actual), (expected)) == 0, "Case-insensitive string equality expectation not met")
+#define TEST_ASSERT_NOT_EQUAL_CASE_INSENSITIVE_CSTRING(actual, expected) TEST_ASSERT(xstrcasecmp((actual), (expected)) != 0, "Case-insensitive string inequality expectation not met")
 
 #define TEST_ASSERT_EQUAL_STRING(actual, expected) TEST_ASSERT(strcmp((actual), (expected)) == 0, "String equality expectation not met")
 #define TEST_ASSERT_NOT_EQUAL_STRING(actual, expected) TEST_ASSERT(strcmp((actual), (expected)) != 0, "String inequality expectation not met")
@@ -363,9 +363,9 @@ TEST_ASSERT(found, "Memory not contains assertion failed");
 #define TEST_ASSERT_CONTAINS_SUBSTRING_STRING(string, substring) TEST_ASSERT(strstr((string), (substring)) != xnullptr, "Substring not found")
 #define TEST_ASSERT_NOT_CONTAINS_SUBSTRING_STRING(string, substring) TEST_ASSERT(strstr((string), (substring)) == xnullptr, "Substring found")
 #define TEST_ASSERT_STARTS_WITH_STRING(string, prefix) TEST_ASSERT(strncmp((string), (prefix), strlen(prefix)) == 0, "String doesn't start with the prefix")
-#define TEST_ASSERT_ENDS_WITH_STRING(string, suffix) TEST_ASSERT((strstr(string, suffix) != xnullptr && strlen(string) >= strlen(suffix) && strcmp(string + strlen(string) - strlen(suffix), suffix)), "String doesn't end with the suffix")
-#define TEST_ASSERT_EQUAL_CASE_INSENSITIVE_STRING(actual, expected) TEST_ASSERT(strcmp((actual), (expected)) == 0, "Case-insensitive string equality expectation not met")
-#define TEST_ASSERT_NOT_EQUAL_CASE_INSENSITIVE_STRING(actual, expected) TEST_ASSERT(strcmp((actual), (expected)) != 0, "Case-insensitive string inequality expectation not met")
+#define TEST_ASSERT_ENDS_WITH_STRING(string, suffix) TEST_ASSERT((strstr(string, suffix) != xnullptr && strlen(string) >= strlen(suffix) && strcmp(string + strlen(string) - strlen(suffix), suffix) == 0), "String doesn't end with the suffix")
+#define TEST_ASSERT_EQUAL_CASE_INSENSITIVE_STRING(actual, expected) TEST_ASSERT(xstrcasecmp((actual), (expected)) == 0, "Case-insensitive string equality expectation not met")
+#define TEST_ASSERT_NOT_EQUAL_CASE_INSENSITIVE_STRING(actual, expected) TEST_ASSERT(xstrcasecmp((actual), (expected)) != 0, "Case-insensitive string inequality expectation not met")
 #endif
 
 // ----------------------------------------------------------------
@@ -23,8 +23,8 @@ extern "C"
 // ----------------------------------------------------------------
 // Memory assertions
 // ----------------------------------------------------------------
-#define TEST_EXPECT_EQUAL_MEMORY(actual, expected, size)     TEST_EXPECT(memcmp(actual, expected, size) != 0, "Expectation for memory equality not met")
-#define TEST_EXPECT_NOT_EQUAL_MEMORY(actual, expected, size) TEST_EXPECT(memcmp(actual, expected, size) == 0, "Expectation for memory inequality not met")
+#define TEST_EXPECT_EQUAL_MEMORY(actual, expected, size)     TEST_EXPECT(memcmp(actual, expected, size) == 0, "Expectation for memory equality not met")
+#define TEST_EXPECT_NOT_EQUAL_MEMORY(actual, expected, size) TEST_EXPECT(memcmp(actual, expected, size) != 0, "Expectation for memory inequality not met")
 #define TEST_EXPECT_CONTAINS_MEMORY(haystack, needle, haystackSize, needleSize) \
 xbool found = xfalse; \
 for (size_t i = 0; i <= (haystackSize - needleSize); i++) { \
@@ -33,7 +33,7 @@ for (size_t i = 0; i <= (haystackSize - needleSize); i++) { \
         break; \
     } \
 } \
-TEST_EXPECT(!found, "Memory contains assertion failed");
+TEST_EXPECT(found, "Memory contains assertion failed");
 
 #define TEST_EXPECT_NOT_CONTAINS_MEMORY(haystack, needle, haystackSize, needleSize) \
 xbool found = xfalse; \
@@ -43,7 +43,7 @@ for (size_t i = 0; i <= (haystackSize - needleSize); i++) { \
         break; \
     } \
 } \
-TEST_EXPECT(found, "Memory not contains assertion failed");
+TEST_EXPECT(!found, "Memory not contains assertion failed");
 
 #define TEST_EXPECT_COPIED_MEMORY(dest, source, size)     TEST_EXPECT((memcmp(dest, source, size) == 0), "Memory copy check failed");
 #define TEST_EXPECT_NOT_COPIED_MEMORY(dest, source, size) TEST_EXPECT((memcmp(dest, source, size) != 0), "Memory not copied check failed");
@@ -55,19 +55,19 @@ TEST_EXPECT(found, "Memory not contains assertion failed");
 #define TEST_EXPECT_NOT_EQUAL(actual, expected) TEST_EXPECT((xbool)(actual) != (xbool)(expected), "Expectation for inequality not met")
 #define TEST_EXPECT_LESS(actual, expected)      TEST_EXPECT((xbool)(actual) <  (xbool)(expected), "Expectation for less than not met")
 #define TEST_EXPECT_GREATER(actual, expected)   TEST_EXPECT((xbool)(actual) >  (xbool)(expected), "Expectation for greater than not met")
-#define TEST_EXPECT_UNLESS(expression)          TEST_EXPECT((expression), "Expectation not met")
+#define TEST_EXPECT_UNLESS(expression)          TEST_EXPECT(!(expression), "Expectation not met")
 #define TEST_EXPECT_TRUE(expression)            TEST_EXPECT((expression), "Expectation for xtrue not met")
 #define TEST_EXPECT_FALSE(expression)           TEST_EXPECT(!(expression), "Expectation for xfalse not met")
-#define TEST_EXPECT_MSG(expression, message)    TEST_EXPECT(!(expression), message)
+#define TEST_EXPECT_MSG(expression, message)    TEST_EXPECT((expression), message)
 
 #define TEST_EXPECT_EQUAL_BOOL(actual, expected)     TEST_EXPECT((xbool)(actual) == (xbool)(expected), "Expectation for equality not met")
 #define TEST_EXPECT_NOT_EQUAL_BOOL(actual, expected) TEST_EXPECT((xbool)(actual) != (xbool)(expected), "Expectation for inequality not met")
 #define TEST_EXPECT_LESS_BOOL(actual, expected)      TEST_EXPECT((xbool)(actual) <  (xbool)(expected), "Expectation for less than not met")
 #define TEST_EXPECT_GREATER_BOOL(actual, expected)   TEST_EXPECT((xbool)(actual) >  (xbool)(expected), "Expectation for greater than not met")
-#define TEST_EXPECT_UNLESS_BOOL(expression)          TEST_EXPECT((expression), "Expectation not met")
+#define TEST_EXPECT_UNLESS_BOOL(expression)          TEST_EXPECT(!(expression), "Expectation not met")
 #define TEST_EXPECT_TRUE_BOOL(expression)            TEST_EXPECT((expression), "Expectation for xtrue not met")
 #define TEST_EXPECT_FALSE_BOOL(expression)           TEST_EXPECT(!(expression), "Expectation for xfalse not met")
-#define TEST_EXPECT_MSG_BOOL(expression, message)    TEST_EXPECT(!(expression), message)
+#define TEST_EXPECT_MSG_BOOL(expression, message)    TEST_EXPECT((expression), message)
 
 // ----------------------------------------------------------------
 // Enum assertions
@@ -263,7 +263,7 @@ TEST_EXPECT(found, "Memory not contains assertion failed");
 // Float assertions
 // ----------------------------------------------------------------
 #define TEST_EXPECT_FLOAT_EQUAL(actual, expected)         TEST_EXPECT(fabs((float)(actual) -  (float)(expected)) < XTEST_FLOAT_EPSILON, "Floating-point value not equal within epsilon")
-#define TEST_EXPECT_FLOAT_NOT_EQUAL(actual, expected)     TEST_EXPECT(fabs((float)(actual) -  (float)(expected)) <= XTEST_FLOAT_EPSILON, "Floating-point value equal within epsilon")
+#define TEST_EXPECT_FLOAT_NOT_EQUAL(actual, expected)     TEST_EXPECT(fabs((float)(actual) -  (float)(expected)) > XTEST_FLOAT_EPSILON, "Floating-point value equal within epsilon")
 #define TEST_EXPECT_FLOAT_LESS(actual, expected)          TEST_EXPECT((float)(actual)      <  (float)(expected),   "Floating-point value not less")
 #define TEST_EXPECT_FLOAT_GREATER(actual, expected)       TEST_EXPECT((float)(actual)      >  (float)(expected),   "Floating-point value not greater")
 #define TEST_EXPECT_FLOAT_GREATER_EQUAL(actual, expected) TEST_EXPECT((float)(actual)      >= (float)(expected),   "Floating-point value not greater or equal")
@@ -283,7 +283,7 @@ TEST_EXPECT(found, "Memory not contains assertion failed");
 // Double assertions
 // ----------------------------------------------------------------
 #define TEST_EXPECT_DOUBLE_EQUAL(actual, expected)         TEST_EXPECT(fabs((double)(actual) - (double)(expected)) <  XTEST_DOUBLE_EPSILON, "Double-precision value not equal within epsilon")
-#define TEST_EXPECT_DOUBLE_NOT_EQUAL(actual, expected)     TEST_EXPECT(fabs((double)(actual) - (double)(expected)) <= XTEST_DOUBLE_EPSILON, "Double-precision value equal within epsilon")
+#define TEST_EXPECT_DOUBLE_NOT_EQUAL(actual, expected)     TEST_EXPECT(fabs((double)(actual) - (double)(expected)) > XTEST_DOUBLE_EPSILON, "Double-precision value equal within epsilon")
 #define TEST_EXPECT_DOUBLE_LESS(actual, expected)          TEST_EXPECT((double)(actual) <  (double)(expected), "Double-precision value not less")
 #define TEST_EXPECT_DOUBLE_GREATER(actual, expected)       TEST_EXPECT((double)(actual) >  (double)(expected), "Double-precision value not greater")
 #define TEST_EXPECT_DOUBLE_GREATER_EQUAL(actual, expected) TEST_EXPECT((double)(actual) >= (double)(expected), "Double-precision value not greater or equal")
@@ -336,8 +336,8 @@ TEST_EXPECT(found, "Memory not contains assertion failed");
 #define TEST_EXPECT_NOT_CONTAINS_SUBSTRING_STRING(string, substring) TEST_EXPECT(strstr((string), (substring)) == xnullptrptr, "Substring found")
 #define TEST_EXPECT_STARTS_WITH_STRING(string, prefix) TEST_EXPECT(strncmp((string), (prefix), strlen(prefix)) == 0, "String doesn't start with the prefix")
 #define TEST_EXPECT_ENDS_WITH_STRING(string, suffix) TEST_EXPECT(strstr((string), (suffix) != xnullptrptr && (strlen(string) - strlen(suffix)) == (strstr(string, suffix) - string)), "String doesn't end with the suffix")
-#define TEST_EXPECT_EQUAL_CASE_INSENSITIVE_STRING(actual, expected) TEST_EXPECT(strcmp((actual), (expected)) == 0, "Case-insensitive string equality expectation not met")
-#define TEST_EXPECT_NOT_EQUAL_CASE_INSENSITIVE_STRING(actual, expected) TEST_EXPECT(strcmp((actual), (expected)) != 0, "Case-insensitive string inequality expectation not met")
+#define TEST_EXPECT_EQUAL_CASE_INSENSITIVE_STRING(actual, expected) TEST_EXPECT(xstrcasecmp((actual), (expected)) == 0, "Case-insensitive string equality expectation not met")
+#define TEST_EXPECT_NOT_EQUAL_CASE_INSENSITIVE_STRING(actual, expected) TEST_EXPECT(xstrcasecmp((actual), (expected)) != 0, "Case-insensitive string inequality expectation not met")
 
 #define TEST_EXPECT_EQUAL_CSTRING(actual, expected) TEST_EXPECT(strcmp((actual), (expected)) == 0, "String equality expectation not met")
 #define TEST_EXPECT_NOT_EQUAL_CSTRING(actual, expected) TEST_EXPECT(strcmp((actual), (expected)) != 0, "String inequality expectation not met")
@@ -345,9 +345,9 @@ TEST_EXPECT(found, "Memory not contains assertion failed");
 #define TEST_EXPECT_CONTAINS_SUBSTRING_CSTRING(string, substring) TEST_EXPECT(strstr((string), (substring)) != xnullptr, "Substring not found")
 #define TEST_EXPECT_NOT_CONTAINS_SUBSTRING_CSTRING(string, substring) TEST_EXPECT(strstr((string), (substring)) == xnullptr, "Substring found")
 #define TEST_EXPECT_STARTS_WITH_CSTRING(string, prefix) TEST_EXPECT(strncmp((string), (prefix), strlen(prefix)) == 0, "String doesn't start with the prefix")
-#define TEST_EXPECT_ENDS_WITH_CSTRING(string, suffix) TEST_EXPECT((strstr(string, suffix) != xnullptr && strlen(string) >= strlen(suffix) && strcmp(string + strlen(string) - strlen(suffix), suffix)), "String doesn't end with the suffix")
-#define TEST_EXPECT_EQUAL_CASE_INSENSITIVE_CSTRING(actual, expected) TEST_EXPECT(strcmp((actual), (expected)) == 0, "Case-insensitive string equality expectation not met")
-#define TEST_EXPECT_NOT_EQUAL_CASE_INSENSITIVE_CSTRING(actual, expected) TEST_EXPECT(strcmp((actual), (expected)) != 0, "Case-insensitive string inequality expectation not met")
+#define TEST_EXPECT_ENDS_WITH_CSTRING(string, suffix) TEST_EXPECT((strstr(string, suffix) != xnullptr && strlen(string) >= strlen(suffix) && strcmp(string + strlen(string) - strlen(suffix), suffix) == 0), "String doesn't end with the suffix")
+#define TEST_EXPECT_EQUAL_CASE_INSENSITIVE_CSTRING(actual, expected) TEST_EXPECT(xstrcasecmp((actual), (expected)) == 0, "Case-insensitive string equality expectation not met")
+#define TEST_EXPECT_NOT_EQUAL_CASE_INSENSITIVE_CSTRING(actual, expected) TEST_EXPECT(xstrcasecmp((actual), (expected)) != 0, "Case-insensitive string inequality expectation not met")
 #else
 #define TEST_EXPECT_EQUAL_CSTRING(actual, expected) TEST_EXPECT(strcmp((actual), (expected)) == 0, "String equality expectation not met")
 #define TEST_EXPECT_NOT_EQUAL_CSTRING(actual, expected) TEST_EXPECT(strcmp((actual), (expected)) != 0, "String inequality expectation not met")
@@ -355,9 +355,9 @@ TEST_EXPECT(found, "Memory not contains assertion failed");
 #define TEST_EXPECT_CONTAINS_SUBSTRING_CSTRING(string, substring) TEST_EXPECT(strstr((string), (substring)) != xnullptr, "Substring not found")
 #define TEST_EXPECT_NOT_CONTAINS_SUBSTRING_CSTRING(string, substring) TEST_EXPECT(strstr((string), (substring)) == xnullptr, "Substring found")
 #define TEST_EXPECT_STARTS_WITH_CSTRING(string, prefix) TEST_EXPECT(strncmp((string), (prefix), strlen(prefix)) == 0, "String doesn't start with the prefix")
-#define TEST_EXPECT_ENDS_WITH_CSTRING(string, suffix) TEST_EXPECT((strstr(string, suffix) != xnullptr && strlen(string) >= strlen(suffix) && strcmp(string + strlen(string) - strlen(suffix), suffix)), "String doesn't end with the suffix")
-#define TEST_EXPECT_EQUAL_CASE_INSENSITIVE_CSTRING(actual, expected) TEST_EXPECT(strcmp((actual), (expected)) == 0, "Case-insensitive string equality expectation not met")
-#define TEST_EXPECT_NOT_EQUAL_CASE_INSENSITIVE_CSTRING(actual, expected) TEST_EXPECT(strcmp((actual), (expected)) != 0, "Case-insensitive string inequality expectation not met")
+#define TEST_EXPECT_ENDS_WITH_CSTRING(string, suffix) TEST_EXPECT((strstr(string, suffix) != xnullptr && strlen(string) >= strlen(suffix) && strcmp(string + strlen(string) - strlen(suffix), suffix) == 0), "String doesn't end with the suffix")
+#define TEST_EXPECT_EQUAL_CASE_INSENSITIVE_CSTRING(actual, expected) TEST_EXPECT(xstrcasecmp((actual), (expected)) == 0, "Case-insensitive string equality expectation not met")
+#define TEST_EXPECT_NOT_EQUAL_CASE_INSENSITIVE_CSTRING(actual, expected) TEST_EXPECT(xstrcasecmp((actual), (expected)) != 0, "Case-insensitive string inequality expectation not met")
 
 #define TEST_EXPECT_EQUAL_STRING(actual, expected) TEST_EXPECT(strcmp((actual), (expected)) == 0, "String equality expectation not met")
 #define TEST_EXPECT_NOT_EQUAL_STRING(actual, expected) TEST_EXPECT(strcmp((actual), (expected)) != 0, "String inequality expectation not met")
@@ -365,9 +365,9 @@ TEST_EXPECT(found, "Memory not contains assertion failed");
 #define TEST_EXPECT_CONTAINS_SUBSTRING_STRING(string, substring) TEST_EXPECT(strstr((string), (substring)) != xnullptr, "Substring not found")
 #define TEST_EXPECT_NOT_CONTAINS_SUBSTRING_STRING(string, substring) TEST_EXPECT(strstr((string), (substring)) == xnullptr, "Substring found")
 #define TEST_EXPECT_STARTS_WITH_STRING(string, prefix) TEST_EXPECT(strncmp((string), (prefix), strlen(prefix)) == 0, "String doesn't start with the prefix")
-#define TEST_EXPECT_ENDS_WITH_STRING(string, suffix) TEST_EXPECT((strstr(string, suffix) != xnullptr && strlen(string) >= strlen(suffix) && strcmp(string + strlen(string) - strlen(suffix), suffix)), "String doesn't end with the suffix")
-#define TEST_EXPECT_EQUAL_CASE_INSENSITIVE_STRING(actual, expected) TEST_EXPECT(strcmp((actual), (expected)) == 0, "Case-insensitive string equality expectation not met")
-#define TEST_EXPECT_NOT_EQUAL_CASE_INSENSITIVE_STRING(actual, expected) TEST_EXPECT(strcmp((actual), (expected)) != 0, "Case-insensitive string inequality expectation not met")
+#define TEST_EXPECT_ENDS_WITH_STRING(string, suffix) TEST_EXPECT((strstr(string, suffix) != xnullptr && strlen(string) >= strlen(suffix) && strcmp(string + strlen(string) - strlen(suffix), suffix) == 0), "String doesn't end with the suffix")
+#define TEST_EXPECT_EQUAL_CASE_INSENSITIVE_STRING(actual, expected) TEST_EXPECT(xstrcasecmp((actual), (expected)) == 0, "Case-insensitive string equality expectation not met")
+#define TEST_EXPECT_NOT_EQUAL_CASE_INSENSITIVE_STRING(actual, expected) TEST_EXPECT(xstrcasecmp((actual), (expected)) != 0, "Case-insensitive string inequality expectation not met")
 #endif
 
 // ----------------------------------------------------------------
@@ -38,6 +38,9 @@ extern "C"
 #include <stdlib.h>
 #include <stddef.h>
 #include <wctype.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 #include <wchar.h>
 #include <ctype.h>
 #include <stdio.h>
@@ -72,12 +75,17 @@ typedef struct {
     xbool ignored;    // Indicates if the test case is ignored
     xbool is_mark;    // Flag to identify benchmark tests
     xbool is_fish;    // Flag to identify Fish AI tests
+    uint32_t timeout; // Timeout in milliseconds, zero falls back to --timeout
+    xbool queued;     // Set once the test case has been handed to the engine
+    xbool is_async;   // Flag to identify async tests run as coroutines
 } xconfig;
 
 // Fixture information with setup and teardown functions
 typedef struct {
     void (*setup)(void);     // Setup function for the fixture
     void (*teardown)(void);  // Teardown function for the fixture
+    xbool shared;            // Setup once for every queued test using it
+    xbool snapshot;          // Setup once and fork a copy of it per test
 } xfixture;
 
 // Structure representing a test case
@@ -88,35 +96,75 @@ struct xtest {
     xfixture fixture;            // The fixture settings
     xconfig config;              // Configuration
     xtime timer;                 // Xtest timer for tracking time
-    struct xtest *prev;             // Pointer to the previous xtest node
-    struct xtest *next;             // Pointer to the next xtest node
 };
 
-// Deque structure
+// Descriptor the test case macros place in the registry section, fixture is
+// the fixture of an XTEST_*_FIXTURE case and null otherwise
+typedef struct {
+    xtest* test_case;   // The registered test case
+    xfixture* fixture;  // The fixture it runs in, if any
+} xregistered;
+
+// Bits of xentry.flags
+#define XTEST_FLAG_IGNORED 0x01u // The test case is ignored
+#define XTEST_FLAG_MARK    0x02u // The test case is a benchmark
+#define XTEST_FLAG_FISH    0x04u // The test case is a Fish AI test
+#define XTEST_FLAG_SHARED  0x08u // The test case runs inside a shared fixture
+#define XTEST_FLAG_ASYNC   0x10u // The test case runs as a coroutine
+#define XTEST_FLAG_SNAPSHOT 0x20u // The test case runs in a fork of its fixture
+#define XTEST_FLAG_FAILED  0x40u // The test case failed or errored in the current run
+#define XTEST_FLAG_DEPENDS 0x80u // The test case has or is a prerequisite of another
+#define XTEST_FLAG_RAN     0x100u // The test case ran to its end in the current run
+
+// Events an async test case can wait for with XTEST_AWAIT_FD
+#define XTEST_AWAIT_READ  0x1 // The descriptor is readable
+#define XTEST_AWAIT_WRITE 0x2 // The descriptor is writable
+#define XTEST_AWAIT_ERROR 0x4 // The descriptor hung up or failed, only reported
+
+// Hot part of a queued test case, everything the scheduler and the workers
+// look at per test case without touching the cold xtest metadata
+typedef struct {
+    void (*test_function)(void); // Function pointer to the test case's implementation
+    uint32_t flags;              // XTEST_FLAG_* bits
+    uint32_t timeout;            // Timeout in milliseconds, zero falls back to --timeout
+} xentry;
+
+// Contiguous growable registry of queued test cases, entries[i] and tests[i]
+// describe the same test case and the engine refers to it by the index i
 typedef struct {
-    xtest *front;   // Front of the deque
-    xtest *rear;    // Rear of the deque
-} xqueue;
+    xentry* entries;   // Hot fields, densely packed
+    xtest** tests;     // Cold metadata: name, fixture and timer
+    uint32_t count;    // Number of queued test cases
+    uint32_t capacity; // Number of slots allocated in both arrays
+} xregistry;
 
 // Statistics for tracking test results
 typedef struct {
-    uint16_t passed_count;   // Number of passed tests
-    uint16_t failed_count;   // Number of failed tests
-    uint16_t ignored_count;  // Number of ignored tests
-    uint16_t error_count;    // Number of error tests
-    uint16_t mark_count;     // Number of benchmark tests
-    uint16_t fish_count;     // Number of Fish AI tests
-    uint16_t test_count;     // Number of tests
-    uint16_t total_count;    // Total number of tests
+    uint32_t passed_count;   // Number of passed tests
+    uint32_t failed_count;   // Number of failed tests
+    uint32_t ignored_count;  // Number of ignored tests
+    uint32_t error_count;    // Number of error tests
+    uint32_t mark_count;     // Number of benchmark tests
+    uint32_t fish_count;     // Number of Fish AI tests
+    uint32_t test_count;     // Number of tests
+    uint32_t total_count;    // Total number of tests
+    uint32_t unrun_count;    // Number of tests left unrun by fail-fast
 } xstats;
 
 // Engine structure to hold overall test statistics and timing information
 typedef struct {
     xstats stats;  // Test statistics including passed, failed, and ignored counts
     xtime timer;   // Xtest timer for tracking time
-    xqueue* queue; // Queue to hold the test cases
+    xregistry registry; // Registry holding the queued test cases
 } xengine;
 
+// Benchmark timer owned by the caller, on its stack or in its own storage, so
+// any number of them can run nested or on several threads at once
+typedef struct {
+    uint64_t start; // Reading of the benchmark clock when the timer was started
+    uint64_t lap;   // Reading of the benchmark clock when the last lap ended
+} xmark_timer;
+
 // =================================================================
 // Initial implementation
 // =================================================================
@@ -126,10 +174,25 @@ xengine xtest_create(int argc, xstring *argv);
 int xtest_erase(xengine *runner);
 void xtest_run_as_test(xengine* engine, xtest* test_case);
 void xtest_run_as_fixture(xengine* engine, xtest* test_case, xfixture* fixture);
+void xtest_run_registered(xengine* engine);
+void xtest_depends_on(xtest* test_case, xtest* prerequisite);
+int xtest_await_fd(int fd, int events);
+void xtest_await_ms(uint32_t ms);
 
 // Runs a test case with a specified fixture within the testing engine
 void xmark_start_benchmark(void);
 uint64_t xmark_stop_benchmark(void);
+void xmark_timer_start(xmark_timer* timer);
+uint64_t xmark_timer_lap(xmark_timer* timer);
+uint64_t xmark_timer_stop(xmark_timer* timer);
+uint64_t xmark_loop_begin(void);
+uint64_t xmark_loop_next(void);
+void xmark_set_bytes_processed(uint64_t bytes);
+void xmark_set_items_processed(uint64_t items);
+void xmark_range_run(void (*body)(uint64_t), uint64_t lo, uint64_t hi, uint64_t multiplier);
+void xmark_alloc_budget(double allocs, double bytes, const xstring file, int line, const xstring func);
+void xmark_keep(const volatile void* value);
+void xmark_clobber(void);
 void mark_duration(xstring duration_type, double expected, double actual);
 
 // Function prototypes for Xtest assertions
@@ -138,6 +201,7 @@ void xignore(const xstring reason, const xstring file, int line, const xstring f
 void xassume(xbool expression, const xstring message, const xstring file, int line, const xstring func);
 void xassert(xbool expression, const xstring message, const xstring file, int line, const xstring func);
 void xexpect(xbool expression, const xstring message, const xstring file, int line, const xstring func);
+int xstrcasecmp(const char* actual, const char* expected);
 
 // =================================================================
 // XTest create and erase commands
@@ -167,13 +231,25 @@ void xexpect(xbool expression, const xstring message, const xstring file, int li
 // Usage: XTEST_RUN_FIXTURE(test_case, fixture);
 #define XTEST_RUN_FIXTURE(test_case, fixture) xtest_run_as_fixture(runner, &test_case, &fixture)
 
-// Macro to define a test case with a fixture.
+// Macro to declare that a test case runs only after another has passed. Test
+// cases with prerequisites are scheduled as a graph on the worker threads,
+// those whose prerequisite failed or was skipped are skipped in turn. Both
+// ends of a dependency run as plain test cases, an async one blocks in its
+// waits and a snapshot fixture is set up around it in process, a notice says
+// so when the run starts.
+// Usage: XTEST_DEPENDS_ON(test_case, prerequisite);
+#define XTEST_DEPENDS_ON(test_case, prerequisite) xtest_depends_on(&test_case, &prerequisite)
+
+// Macro to define a test case with a fixture. XTEST_IMPORT_ALL() queues it in
+// that fixture unless a pool queued it already.
 // Usage: XTEST_CASE_FIXTURE(fixture_name, test_case) {
 //          // Define and implement the test case
 //        }
 #define XTEST_CASE_FIXTURE(fixture_name, test_case) \
     void test_case##_xtest_##fixture_name(void); \
+    extern xfixture fixture_name; \
     xtest test_case = { #test_case, test_case##_xtest_##fixture_name, {xnullptr, xnullptr}, {xfalse, xfalse, xfalse}, {0, 0, 0}}; \
+    XTEST_REGISTER_WITH(test_case, &fixture_name) \
     void test_case##_xtest_##fixture_name(void)
 
 // Macro to define a marked (excluded) test case with a fixture.
@@ -182,7 +258,9 @@ void xexpect(xbool expression, const xstring message, const xstring file, int li
 //        }
 #define XTEST_MARK_FIXTURE(fixture_name, test_case) \
     void test_case##_xtest_##fixture_name(void); \
+    extern xfixture fixture_name; \
     xtest test_case = { #test_case, test_case##_xtest_##fixture_name, {xnullptr, xnullptr}, {xfalse, xtrue, xfalse}, {0, 0, 0}}; \
+    XTEST_REGISTER_WITH(test_case, &fixture_name) \
     void test_case##_xtest_##fixture_name(void)
 
 // Macro to define a focused (exclusive) test case with a fixture.
@@ -191,7 +269,9 @@ void xexpect(xbool expression, const xstring message, const xstring file, int li
 //        }
 #define XTEST_FISH_FIXTURE(fixture_name, test_case) \
     void test_case##_xtest_##fixture_name(void); \
+    extern xfixture fixture_name; \
     xtest test_case = { #test_case, test_case##_xtest_##fixture_name, {xnullptr, xnullptr}, {xfalse, xfalse, xtrue}, {0, 0, 0}}; \
+    XTEST_REGISTER_WITH(test_case, &fixture_name) \
     void test_case##_xtest_##fixture_name(void)
 
 // Macro to define a fixture.
@@ -203,6 +283,28 @@ void xexpect(xbool expression, const xstring message, const xstring file, int li
     void teardown_##fixture_name(void); \
     xfixture fixture_name = { setup_##fixture_name, teardown_##fixture_name };
 
+// Macro to define a fixture shared by a group of tests, the engine groups the
+// queued tests using it and runs setup and teardown once around the group.
+// Usage: XTEST_FIXTURE_SHARED(fixture_name) {
+//          // Define setup and teardown functions for the fixture
+//        }
+#define XTEST_FIXTURE_SHARED(fixture_name) \
+    void setup_##fixture_name(void); \
+    void teardown_##fixture_name(void); \
+    xfixture fixture_name = { setup_##fixture_name, teardown_##fixture_name, xtrue };
+
+// Macro to define a fixture whose state the tests may change. The engine runs
+// setup once in a template process and forks it for every queued test using
+// the fixture, so each test starts from a pristine copy-on-write snapshot and
+// teardown runs once in the template. Without fork it acts as XTEST_FIXTURE.
+// Usage: XTEST_FIXTURE_SNAPSHOT(fixture_name) {
+//          // Define setup and teardown functions for the fixture
+//        }
+#define XTEST_FIXTURE_SNAPSHOT(fixture_name) \
+    void setup_##fixture_name(void); \
+    void teardown_##fixture_name(void); \
+    xfixture fixture_name = { setup_##fixture_name, teardown_##fixture_name, xfalse, xtrue };
+
 // Macro to define the setup function for a fixture.
 // Usage: XTEST_SETUP(fixture_name) {
 //          // Define the setup function for the fixture
@@ -234,6 +336,29 @@ void xexpect(xbool expression, const xstring message, const xstring file, int li
 #define XTEST_IMPORT_POOL(group_name) group_name(&runner)
 
 
+// =================================================================
+// Test registry commands
+// =================================================================
+
+// On ELF targets every XTEST_CASE, XTEST_MARK and XTEST_FISH, and their
+// _FIXTURE variants, also drops an xregistered descriptor into the
+// xtest_registry section. The linker lays the descriptors out back to back
+// between __start_xtest_registry and __stop_xtest_registry, so the engine
+// finds every defined test case without any registration call. Elsewhere the
+// registry is empty.
+#if defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+#define XTEST_REGISTRY_SECTION 1
+#define XTEST_REGISTER_WITH(name, fixture) \
+    static const xregistered name##_xtest_entry __attribute__((used, section("xtest_registry"), aligned(sizeof(void *)))) = { &name, fixture };
+#else
+#define XTEST_REGISTER_WITH(name, fixture)
+#endif
+#define XTEST_REGISTER(name) XTEST_REGISTER_WITH(name, xnullptr)
+
+// Macro to queue every test case in the registry that no pool has queued yet.
+// Usage: XTEST_IMPORT_ALL();
+#define XTEST_IMPORT_ALL() xtest_run_registered(&runner)
+
 // =================================================================
 // Implement test commands
 // =================================================================
@@ -245,8 +370,42 @@ void xexpect(xbool expression, const xstring message, const xstring file, int li
 #define XTEST_CASE(name) \
     void name##_xtest(void); \
     xtest name = { #name, name##_xtest, {xnullptr, xnullptr}, {xfalse, xfalse, xfalse}, {0, 0, 0}}; \
+    XTEST_REGISTER(name) \
     void name##_xtest(void)
 
+// Macro to define a basic test case that errors out when it runs longer than
+// the given number of milliseconds, overriding the --timeout option.
+// Usage: XTEST_CASE_TIMEOUT(test_name, 500) {
+//          // Test case implementation
+//        }
+#define XTEST_CASE_TIMEOUT(name, ms) \
+    void name##_xtest(void); \
+    xtest name = { #name, name##_xtest, {xnullptr, xnullptr}, {xfalse, xfalse, xfalse, ms}, {0, 0, 0}}; \
+    XTEST_REGISTER(name) \
+    void name##_xtest(void)
+
+// Macro to define an async test case. The engine runs async test cases as
+// coroutines on one event loop thread, a case waiting in XTEST_AWAIT_FD or
+// XTEST_AWAIT_MS lets the others run. On platforms without the event loop the
+// case runs like any other and the waits block.
+// Usage: XTEST_ASYNC_CASE(test_name) {
+//          // Test case implementation
+//        }
+#define XTEST_ASYNC_CASE(name) \
+    void name##_xtest(void); \
+    xtest name = { #name, name##_xtest, {xnullptr, xnullptr}, {xfalse, xfalse, xfalse, 0, xfalse, xtrue}, {0, 0, 0}}; \
+    XTEST_REGISTER(name) \
+    void name##_xtest(void)
+
+// Macro to wait until a descriptor is ready for XTEST_AWAIT_READ and/or
+// XTEST_AWAIT_WRITE, evaluates to the events that are ready.
+// Usage: int ready = XTEST_AWAIT_FD(fd, XTEST_AWAIT_READ);
+#define XTEST_AWAIT_FD(fd, events) xtest_await_fd(fd, events)
+
+// Macro to wait for the given number of milliseconds.
+// Usage: XTEST_AWAIT_MS(50);
+#define XTEST_AWAIT_MS(ms) xtest_await_ms(ms)
+
 // Macro to define a test case and mark it for exclusion from the test suite.
 // Usage: XTEST_MARK(test_name) {
 //          // Test case implementation
@@ -254,8 +413,28 @@ void xexpect(xbool expression, const xstring message, const xstring file, int li
 #define XTEST_MARK(name) \
     void name##_xtest(void); \
     xtest name = { #name, name##_xtest, {xnullptr, xnullptr}, {xfalse, xtrue, xfalse}, {0, 0, 0}}; \
+    XTEST_REGISTER(name) \
     void name##_xtest(void)
 
+// Macro to define a benchmark run over a geometric range of input sizes,
+// lo, lo * multiplier and so on up to hi. XMARK_RANGE() is the size of the
+// run in progress, the median time of each size is reported followed by the
+// complexity among O(1), O(log n), O(n), O(n log n) and O(n^2) that fits
+// the timings best.
+// Usage: XTEST_MARK_RANGE(test_name, 8, 512, 4) {
+//          // Benchmark for an input of XMARK_RANGE() elements
+//        }
+#define XTEST_MARK_RANGE(name, lo, hi, multiplier) \
+    void name##_xtest_range(uint64_t xmark_range); \
+    void name##_xtest(void); \
+    xtest name = { #name, name##_xtest, {xnullptr, xnullptr}, {xfalse, xtrue, xfalse}, {0, 0, 0}}; \
+    XTEST_REGISTER(name) \
+    void name##_xtest(void) { xmark_range_run(name##_xtest_range, lo, hi, multiplier); } \
+    void name##_xtest_range(uint64_t xmark_range)
+
+// Macro for the input size an XTEST_MARK_RANGE body is running for
+#define XMARK_RANGE() (xmark_range)
+
 // Macro to define a test case with a focus on specific functionality.
 // Usage: XTEST_FISH(test_name) {
 //          // Test case implementation
@@ -263,6 +442,7 @@ void xexpect(xbool expression, const xstring message, const xstring file, int li
 #define XTEST_FISH(name) \
     void name##_xtest(void); \
     xtest name = { #name, name##_xtest, {xnullptr, xnullptr}, {xfalse, xfalse, xtrue}, {0, 0, 0}}; \
+    XTEST_REGISTER(name) \
     void name##_xtest(void)
 
 // =================================================================
@@ -313,10 +493,47 @@ void xexpect(xbool expression, const xstring message, const xstring file, int li
 // XMark specific commands for benchmarking
 // =================================================================
 
-// Define macros for starting and stopping benchmarks
+// Define macros for starting and stopping benchmarks, they share one timer per thread
 #define XMARK_START_BENCHMARK() xmark_start_benchmark() // Macro for starting benchmark
 #define XMARK_STOP_BENCHMARK() xmark_stop_benchmark()   // Macro for stopping benchmark
 
+// Macros for timer handles, each xmark_timer variable times on its own so
+// phases of one benchmark can be timed apart or nested.
+// Usage: xmark_timer timer;
+//        XMARK_TIMER_START(timer);
+//        uint64_t parse = XMARK_TIMER_LAP(timer);  // nanoseconds since the start
+//        uint64_t solve = XMARK_TIMER_LAP(timer);  // nanoseconds since the last lap
+//        uint64_t total = XMARK_TIMER_STOP(timer); // nanoseconds since the start
+#define XMARK_TIMER_START(timer) xmark_timer_start(&(timer)) // Macro for starting a timer handle
+#define XMARK_TIMER_LAP(timer) xmark_timer_lap(&(timer))     // Macro for timing a lap of a timer handle
+#define XMARK_TIMER_STOP(timer) xmark_timer_stop(&(timer))   // Macro for stopping a timer handle
+
+// Macros that keep the optimizer from deleting the work being timed.
+// XMARK_KEEP makes the compiler believe the value is read, so the code that
+// computed it stays. XMARK_CLOBBER makes it believe all memory is read and
+// written, so stores into buffers are not dropped or moved across it. GCC
+// and Clang get an empty inline asm, other compilers a call into the library
+// that stores the address in a volatile sink, there the value must be a
+// variable.
+// Usage: XMARK_LOOP() {
+//          uint64_t sum = checksum(buffer, size);
+//          XMARK_KEEP(sum);
+//        }
+#if defined(__GNUC__) || defined(__clang__)
+#define XMARK_KEEP(value) \
+    do { \
+        __typeof__(value) xmark_kept = (value); \
+        __asm__ __volatile__("" : : "r,m"(xmark_kept) : "memory"); \
+    } while (0)
+#define XMARK_CLOBBER() __asm__ __volatile__("" : : : "memory")
+#elif defined(_MSC_VER)
+#define XMARK_KEEP(value) do { xmark_keep((const volatile void*)&(value)); _ReadWriteBarrier(); } while (0)
+#define XMARK_CLOBBER() _ReadWriteBarrier()
+#else
+#define XMARK_KEEP(value) xmark_keep((const volatile void*)&(value))
+#define XMARK_CLOBBER() xmark_clobber()
+#endif
+
 // Define macro for marking duration with given units
 #define XMARK_DURATION(duration, elapsed, actual) mark_duration(duration, elapsed, actual)  // Macro for marking duration with specified units
 
@@ -326,6 +543,34 @@ void xexpect(xbool expression, const xstring message, const xstring file, int li
 #define XMARK_DURATION_MILLISECONDS(elapsed, actual) XMARK_DURATION("milliseconds", elapsed, actual)  // Macro for marking duration in milliseconds
 #define XMARK_DURATION_MICROSECONDS(elapsed, actual) XMARK_DURATION("picoseconds", elapsed, actual)  // Macro for marking duration in microseconds
 
+// Macro to run the statement that follows as a calibrated benchmark loop. The
+// iteration count grows until one batch takes --mark-time / --mark-samples,
+// a warmup follows, then --mark-samples batches are timed and the min, median,
+// mean, stddev, p90, p99 and outliers per iteration are reported for the case.
+// Usage: XMARK_LOOP() {
+//          // Code to benchmark
+//        }
+#define XMARK_LOOP() \
+    for (uint64_t xmark_batch = xmark_loop_begin(); xmark_batch > 0; xmark_batch = xmark_loop_next()) \
+        for (uint64_t xmark_iter = 0; xmark_iter < xmark_batch; xmark_iter++)
+
+// Macros to declare the work one iteration of the XMARK_LOOP that follows
+// does, the throughput at the median time is reported next to the times and
+// --mark-compare compares throughput instead of time.
+// Usage: XMARK_SET_BYTES_PROCESSED(sizeof(buffer));
+//        XMARK_SET_ITEMS_PROCESSED(record_count);
+//        XMARK_LOOP() { parse(buffer, record_count); }
+#define XMARK_SET_BYTES_PROCESSED(bytes) xmark_set_bytes_processed((uint64_t)(bytes)) // Macro for bytes per iteration
+#define XMARK_SET_ITEMS_PROCESSED(items) xmark_set_items_processed((uint64_t)(items)) // Macro for items per iteration
+
+// Macro to fail the benchmark when an iteration of the XMARK_LOOP that follows
+// allocates more often or more bytes than allowed. Allocations are counted
+// in glibc builds configured with -Dwith_alloc_hooks=enabled, which report
+// allocs and bytes per iteration for every XMARK_LOOP.
+// Usage: XMARK_ALLOC_BUDGET(0, 0); // the loop must not touch the heap
+//        XMARK_LOOP() { parse(buffer); }
+#define XMARK_ALLOC_BUDGET(allocs, bytes) xmark_alloc_budget((double)(allocs), (double)(bytes), __FILE__, __LINE__, (const xstring)__func__)
+
 // ------------------------------------------------------------------------
 //
 // List of handy assert types from the XUnit Test framework
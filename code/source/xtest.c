@@ -13,6 +13,50 @@ Description:
 #include "fossil/xtest.h"
 #include <stdarg.h>
 
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <unistd.h>
+#include <errno.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <regex.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+#if defined(__linux__)
+#define XTEST_ASYNC_LOOP 1
+#define XTEST_PERF_COUNTERS 1
+#include <linux/perf_event.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <ucontext.h>
+#endif
+
+// Built with -Dwith_alloc_hooks=enabled the library replaces malloc, calloc,
+// realloc and free with wrappers that forward to the glibc allocator and
+// count what the benchmark loops allocate
+#if defined(XTEST_ALLOC_HOOKS) && defined(__GLIBC__)
+#define XMARK_ALLOC_COUNTING 1
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define XMARK_TSC 1
+#include <cpuid.h>
+#include <x86intrin.h>
+#elif (defined(_M_X64) || defined(_M_IX86)) && defined(_MSC_VER)
+#define XMARK_TSC 1
+#include <intrin.h>
+#endif
+
 typedef struct {
     xbool cutback;
     xbool verbose;
@@ -24,22 +68,472 @@ typedef struct {
     xbool color;
     xbool ci;
     xbool repeat;
-    uint8_t iter_repeat;
+    uint32_t iter_repeat;
+    double repeat_for;
+    uint16_t jobs;
+    xbool isolate;
+    xstring history;
+    double default_cost;
+    uint32_t shard_index;
+    uint32_t shard_count;
+    uint32_t fail_fast;
+    uint32_t timeout;
+    xbool shuffle;
+    uint64_t shuffle_seed;
+    uint32_t shuffle_runs;
+    double mark_time;
+    uint32_t mark_samples;
+    xbool mark_counters;
+    uint8_t mark_clock;
+    xstring mark_baseline;
+    xstring mark_compare;
+    double mark_threshold;
 } xparser;
 
 // Global xparser variable
 xparser xcli;
 
+#if defined(_MSC_VER)
+#define XTEST_THREAD_LOCAL __declspec(thread)
+#else
+#define XTEST_THREAD_LOCAL _Thread_local
+#endif
+
+// Control panel for assert/expect and marks, every worker thread gets its
+// own copy so test cases running side by side do not see each others state.
+typedef struct {
+    uint8_t pass_scan;     // Cleared once an assert, expect or mark fails
+    uint8_t assume_issues; // Number of failed assumptions in the test case
+    uint8_t ignore_case;   // Set when the test case asks to be skipped
+    uint8_t errors_case;   // Set when the test case reports an error
+} xcontext;
+
+static XTEST_THREAD_LOCAL xcontext XTEST_CONTEXT = {xtrue, 0, xfalse, xfalse};
+
+// Test case whose body is running on this thread, xnullptr outside of one
+static XTEST_THREAD_LOCAL xtest* XTEST_RUNNING = xnullptr;
+
+// Phases of a benchmark loop
+#define XMARK_CALIBRATE 0 // Growing the batch until it takes the target time
+#define XMARK_WARMUP    1 // Running batches that are not recorded
+#define XMARK_SAMPLE    2 // Recording one sample per batch
+
+// Clocks of --mark-clock that benchmarks are timed with
+#define XMARK_CLOCK_MONOTONIC  0 // CLOCK_MONOTONIC, QueryPerformanceCounter on Windows
+#define XMARK_CLOCK_RAW        1 // CLOCK_MONOTONIC_RAW, free of NTP slewing
+#define XMARK_CLOCK_THREAD_CPU 2 // CPU time of the calling thread
+#define XMARK_CLOCK_TSC        3 // Invariant time stamp counter, read in user space
+
+// Largest batch a benchmark loop grows to
+#define XMARK_MAX_BATCH 1000000000ULL
+
+// Hardware counters of --mark-counters, in the order they join the group
+#define XMARK_CYCLES        0
+#define XMARK_INSTRUCTIONS  1
+#define XMARK_L1_MISSES     2
+#define XMARK_LLC_MISSES    3
+#define XMARK_BRANCH_MISSES 4
+#define XMARK_COUNTERS      5
+
+// Group of hardware counters of one thread, cycles lead the group so all of
+// them are scheduled onto the PMU together and count the same instructions
+typedef struct {
+    xbool active;                  // Set while the group is open
+    int fds[XMARK_COUNTERS];       // Descriptor of each counter, -1 when refused
+    int8_t slots[XMARK_COUNTERS];  // Position of each counter in a group read, -1 when refused
+    uint8_t members;               // Counters in the group
+} xcounters;
+
+// Benchmark loop in progress on this thread, see XMARK_LOOP
+typedef struct {
+    uint8_t phase;    // XMARK_CALIBRATE, XMARK_WARMUP or XMARK_SAMPLE
+    uint64_t batch;   // Iterations per timed batch
+    uint64_t target;  // Nanoseconds a batch should take
+    uint64_t start;   // Clock reading when the batch in flight started
+    uint64_t warmup;  // Nanoseconds spent warming up so far
+    double* samples;  // Nanoseconds per iteration of each recorded batch
+    uint32_t count;   // Number of samples recorded
+    xcounters counters; // Hardware counters around the recorded batches
+} xmark_loop;
+
+static XTEST_THREAD_LOCAL xmark_loop XMARK_STATE;
+
+// Nanoseconds per tick of the benchmark clock, only the time stamp counter
+// ticks at anything else and gets its rate from xmark_clock_setup
+static double XMARK_TICK_NS = 1.0;
+
+// Nanoseconds two back to back readings of the benchmark clock are apart, a
+// timed region within XMARK_OVERHEAD_FACTOR of it measured little but the
+// timer. Short regions are common in real benchmarks, so --verbose alone
+// reports them.
+static double XMARK_OVERHEAD_NS = 0.0;
+#define XMARK_OVERHEAD_FACTOR 2.0
+
+// Time per iteration of XMARK_LOOP below which the body most likely got
+// optimized away, less than one clock cycle of any current processor
+#define XMARK_EMPTY_ITERATION_NS 0.5
+
+// Set once this test case was told its timings are suspiciously short
+static XTEST_THREAD_LOCAL xbool XMARK_OVERHEAD_WARNED = xfalse;
+
+// Sink of XMARK_KEEP on compilers without inline asm
+static const volatile void* volatile XMARK_SINK = xnullptr;
+// Summary of the samples of a benchmark loop, times per iteration in nanoseconds
+typedef struct {
+    double min;             // Fastest sample
+    double median;          // Middle sample
+    double mean;            // Average of the samples
+    double stddev;          // Sample standard deviation
+    double p90;             // 90th percentile
+    double p99;             // 99th percentile
+    uint32_t low_outliers;  // Samples below the lower Tukey fence
+    uint32_t high_outliers; // Samples above the upper Tukey fence
+    uint32_t samples;       // Number of samples
+    uint64_t batch;         // Iterations per sample
+    double counters[XMARK_COUNTERS]; // Counts per iteration, negative when not counted
+    uint64_t bytes;         // Bytes processed per iteration, zero when not set
+    uint64_t items;         // Items processed per iteration, zero when not set
+    double allocs;          // Allocations per iteration, negative when not counted
+    double frees;           // Frees per iteration, negative when not counted
+    double allocated;       // Bytes allocated per iteration, negative when not counted
+} xmark_stats;
+
+// Allocations of this thread, counted while a benchmark loop takes samples
+typedef struct {
+    xbool active;       // Set while the samples of XMARK_LOOP are taken
+    uint64_t allocs;    // Calls to malloc, calloc and realloc
+    uint64_t frees;     // Calls to free, with a pointer
+    uint64_t bytes;     // Bytes asked for by those allocations
+} xmark_allocs;
+
+static XTEST_THREAD_LOCAL xmark_allocs XMARK_ALLOCS = {xfalse, 0, 0, 0};
+
+// Most a benchmark may allocate per iteration, see XMARK_ALLOC_BUDGET
+typedef struct {
+    xbool set;          // Set once the benchmark declared a budget
+    double allocs;      // Allocations per iteration allowed
+    double bytes;       // Bytes per iteration allowed
+    const char* file;   // Where the budget was declared
+    int line;
+    const char* func;
+} xmark_budget;
+
+static XTEST_THREAD_LOCAL xmark_budget XMARK_BUDGET = {xfalse, 0.0, 0.0, xnullptr, 0, xnullptr};
+
+// Work one iteration of XMARK_LOOP does, set by the benchmark for throughput
+typedef struct {
+    uint64_t bytes; // XMARK_SET_BYTES_PROCESSED
+    uint64_t items; // XMARK_SET_ITEMS_PROCESSED
+} xmark_processed;
+
+static XTEST_THREAD_LOCAL xmark_processed XMARK_PROCESSED = {0, 0};
+
+// Most input sizes an XTEST_MARK_RANGE sweep runs, enough for any range of
+// 64 bit sizes growing at least twofold
+#define XMARK_RANGE_MAX 65
+
+// Input size sweep of XTEST_MARK_RANGE in progress on this thread
+typedef struct {
+    xbool active;     // Set while the body runs for one of the sizes
+    uint64_t size;    // Input size the body is running for
+    double median;    // Median time per iteration its XMARK_LOOP measured
+    xbool measured;   // Set once the XMARK_LOOP of the body has finished
+} xmark_range;
+
+static XTEST_THREAD_LOCAL xmark_range XMARK_RANGE_STATE = {xfalse, 0, 0.0, xfalse};
+
+// Failures seen by all workers, once --fail-fast is reached the workers stop
+// taking new test cases and the ones in flight are left to finish.
+static uint32_t XTEST_FAILURES = 0;
+
+#if defined(_WIN32)
+#define xatomic_load(ptr)     (*(ptr))
+#define xatomic_store(ptr, v) (*(ptr) = (v))
+#define xatomic_add(ptr, n)   (*(ptr) += (n))
+#define xatomic_sub(ptr, n)   (*(ptr) -= (n))
+#else
+#define xatomic_load(ptr)     __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define xatomic_store(ptr, v) __atomic_store_n(ptr, v, __ATOMIC_RELEASE)
+#define xatomic_add(ptr, n)   __atomic_add_fetch(ptr, n, __ATOMIC_ACQ_REL)
+#define xatomic_sub(ptr, n)   __atomic_sub_fetch(ptr, n, __ATOMIC_ACQ_REL)
+#endif
+
 static uint8_t ASSUME_MAX    = 5;
-static uint8_t ASSUME_ISSUES = 0;
 
-// Static control panel for assert/expect and marks
-static uint8_t XTEST_PASS_SCAN = xtrue;
-static uint8_t XIGNORE_TEST_CASE = xfalse;
-static uint8_t XERRORS_TEST_CASE = xfalse;
+static uint32_t MAX_REPEATS = UINT32_MAX;
+static uint32_t MIN_REPEATS = 1;
+
+static uint16_t MAX_JOBS = 256;
+static uint16_t MIN_JOBS = 1;
+
+static double DEFAULT_COST_MS = 1.0;
+
+static double DEFAULT_MARK_TIME_MS = 100.0;
+static uint32_t DEFAULT_MARK_SAMPLES = 20;
+static uint32_t MAX_MARK_SAMPLES = 1000;
+static uint32_t MIN_MARK_SAMPLES = 5;
+
+static double DEFAULT_MARK_THRESHOLD = 5.0;
+static double MARK_ALPHA = 0.01; // Significance level of the baseline comparison
+
+// Recorded duration of a test case in the run history
+typedef struct {
+    xstring name;  // Name of the test case
+    uint64_t cost; // Duration of its last run in microseconds
+} xhistory_entry;
+
+// Open addressing table of durations loaded from and saved to --history
+typedef struct {
+    xhistory_entry* entries; // Slots of the table, empty slots have no name
+    size_t capacity;         // Number of slots, always a power of two
+    size_t count;            // Number of used slots
+} xhistory;
+
+static xhistory XHISTORY = {xnullptr, 0, 0};
+
+// Samples of one benchmark, nanoseconds per iteration of each batch
+typedef struct {
+    xstring name;     // Name of the benchmark
+    double* samples;  // Samples in ascending order
+    uint32_t count;   // Number of samples
+    xmark_processed processed; // Work of one iteration, zero when not set
+} xbaseline_entry;
+
+// Sample distributions of the benchmarks, kept in first seen order
+typedef struct {
+    xbaseline_entry* entries; // Benchmarks of the table
+    size_t count;             // Number of benchmarks
+    size_t capacity;          // Allocated entries
+} xbaseline;
+
+static xbaseline XBASELINE = {xnullptr, 0, 0};  // Recorded by this run
+static uint32_t XMARK_REGRESSIONS = 0;          // Benchmarks slower than --mark-compare
+
+#if !defined(_WIN32)
+static pthread_mutex_t XBASELINE_LOCK = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+// Test name patterns given to --filter or --exclude. Globs and /regex/
+// patterns are compiled once into a single alternation so each name is
+// matched by one pass of the regex automaton.
+typedef struct {
+    xstring* patterns;  // Patterns as given on the command line
+    uint32_t count;     // Number of patterns
+#if !defined(_WIN32)
+    regex_t automaton;  // Every pattern as one extended regular expression
+    xbool compiled;     // Set once the automaton holds the patterns
+#endif
+} xfilter;
+
+static xfilter XFILTER_INCLUDE;
+static xfilter XFILTER_EXCLUDE;
+
+// Number of queued test cases left out by the filters
+static uint32_t XTEST_FILTERED = 0;
+
+// Resource usage of the process at one point of a soak run, negative values
+// are metrics the platform cannot provide
+typedef struct {
+    double elapsed;   // Seconds since the soak run started
+    double rss;       // Resident set size in bytes
+    double fds;       // Open file descriptors
+    double threads;   // Threads of the process
+    double iteration; // Mean nanoseconds per body run since the previous sample
+} xsample;
+
+// State of a soak run, the selected test cases are run in rounds until
+// --repeat-for is over while a sampler thread records resource usage
+typedef struct {
+    xsample* samples;    // Samples in the order they were taken
+    size_t count;        // Number of samples taken
+    size_t capacity;     // Number of samples allocated
+    uint32_t rounds;     // Rounds of the selected test cases run so far
+    uint64_t iterations; // Test case bodies run so far, added to by the workers
+    uint64_t nanos;      // Nanoseconds spent in those bodies
+    uint32_t stop;       // Set to stop the sampler thread
+    xbool active;        // Set while the bodies are timed for the sampler
+#if !defined(_WIN32)
+    pthread_t thread;    // Thread taking the samples
+#endif
+} xsoak;
+
+static xsoak XSOAK;
+
+// Outcome of a test case over the orders of --shuffle-runs
+typedef struct {
+    xtest* test;       // Test case, orders are matched up by its address
+    uint32_t failures; // Number of orders it failed or errored in
+    uint64_t seed;     // Seed of the first order it failed in
+} xoutcome;
+
+// State of a shuffled run, every order is a permutation of the selected test
+// cases drawn from its own seed so any one of them can be replayed alone
+typedef struct {
+    xentry* entries;     // Selected test cases before the first shuffle
+    xtest** tests;       // Metadata of those test cases
+    xoutcome* outcomes;  // Outcomes sorted by test case address
+    uint32_t count;      // Number of selected test cases
+    uint32_t runs;       // Orders run to the end so far
+    uint32_t dependent;  // Test cases whose outcome changed with the order
+} xshuffle;
+
+static xshuffle XSHUFFLE;
+
+// Prerequisite declared with XTEST_DEPENDS_ON
+typedef struct {
+    xtest* test;         // Test case that waits
+    xtest* prerequisite; // Test case it waits for
+} xdependency;
+
+// Every dependency declared so far, in declaration order
+typedef struct {
+    xdependency* edges; // Declared dependencies
+    uint32_t count;     // Number of dependencies
+    uint32_t capacity;  // Number of dependencies allocated
+} xdepends;
+
+static xdepends XDEPENDS = {xnullptr, 0, 0};
+
+// Dependency graph of the test cases a pool of workers is running, indexed
+// by registry position. A test case is handed to a worker once the count of
+// its unfinished prerequisites drops to zero.
+typedef struct {
+    uint32_t* offsets;    // Dependents of i are dependents[offsets[i] .. offsets[i + 1])
+    uint32_t* dependents; // Registry positions of the dependents
+    uint32_t* pending;    // Prerequisites of each test case not finished yet
+    uint32_t* blocker;    // Prerequisite that did not pass, XTEST_NONE when none
+    uint32_t waiting;     // Test cases still held back by a prerequisite
+    xbool active;         // Set while a graph is being run
+} xgraph;
+
+static xgraph XGRAPH;
+
+#if defined(XTEST_REGISTRY_SECTION)
+// Bounds of the registry section, weak so a program without any registered
+// test case still links and simply sees an empty registry
+extern const xregistered __start_xtest_registry[] __attribute__((weak));
+extern const xregistered __stop_xtest_registry[] __attribute__((weak));
+#endif
+
+static uint32_t xtest_count_unqueued(void);
+static uint32_t* xgraph_groups(xregistry* registry);
+static void xmark_clock_setup(void);
+static double xmark_percentile(const double* sorted, uint32_t count, double p);
+static int xmark_compare_double(const void* lhs, const void* rhs);
+
+// Totals of shared fixture work, reported apart from the test case timings
+static clock_t XFIXTURE_TIME = 0;
+static uint32_t XFIXTURE_SETUPS = 0;
+
+// No test case, used where an index into the registry is optional
+#define XTEST_NONE UINT32_MAX
+
+// Test cases whose fixture is set up once for a whole unit of them
+#define XTEST_FLAG_GROUPED (XTEST_FLAG_SHARED | XTEST_FLAG_SNAPSHOT)
+
+// Deque of indices into the registry, the owner pops from the tail and
+// thieves take from the head
+typedef struct {
+    uint32_t* slots;   // Indices of the test cases, head to tail
+    uint32_t head;     // First used slot
+    uint32_t tail;     // Slot past the last used one
+    uint32_t capacity; // Number of slots allocated
+} xdeque;
+
+// Worker state used while draining the queue, each worker owns a deque of
+// test cases and keeps its own scoreboard which is merged back into the
+// engine once every deque is empty.
+typedef struct xworker xworker;
+struct xworker {
+    xengine* engine;      // Engine that owns the test cases being run
+    xstats stats;         // Scoreboard local to this worker
+    xdeque deque;         // Test cases owned by this worker
+    xfixture active;      // Shared fixture currently set up by this worker
+    clock_t fixture_time; // Time spent in shared fixture setup and teardown
+    uint32_t fixture_setups; // Number of shared fixture setups performed
+    xworker* pool;        // All workers, used to steal work when idle
+    uint16_t count;       // Number of workers in the pool
+    uint16_t id;          // Position of this worker in the pool
+#if !defined(_WIN32)
+    pthread_t thread;     // Thread running this worker
+    pthread_mutex_t lock; // Guards the deque against thieves and the watchdog
+    uint32_t running;     // Test case in flight while a timeout applies to it
+    clock_t deadline;     // When the test case in flight times out
+    uint32_t shift;       // Bumped each time a relief thread takes over the worker
+    xbool supervised;     // Set when the watchdog enforces timeouts
+    xbool abandoned;      // Set once no thread is left to drain the deque
+    xbool finished;       // Set once the worker ran out of work
+#endif
+};
+
+#if !defined(_WIN32)
+
+// Worker process of the pre-forked pool used by --isolate=fork
+typedef struct {
+    pid_t pid;       // Process id of the worker, zero once it has exited
+    int request_fd;  // Parent writes the index of the next test case here
+    int result_fd;   // Parent reads result records back from here
+    int32_t current; // Index of the test case in flight, -1 when idle
+    uint32_t end;    // Index past the last test case of the unit in flight
+    clock_t started; // When the test case in flight was handed out
+    xbool timed_out; // Set when the worker was killed for running too long
+} xprocess;
+
+// Unit of work the parent hands to a worker process, a single test case or
+// the run of test cases sharing a fixture
+typedef struct {
+    uint32_t first;  // Index of the first test case in the dispatch table
+    uint32_t end;    // Index past the last test case
+} xrequest;
+
+// Compact record a worker process streams back for each test case
+typedef struct {
+    uint32_t index;  // Index of the test case in the dispatch table
+    clock_t elapsed; // Time the test case took inside the worker
+    clock_t fixture; // Time spent in shared fixture setup and teardown
+    uint16_t setups; // Number of shared fixture setups performed
+    xstats stats;    // Scoreboard produced by the test case
+    int32_t status;  // Wait status of a snapshot child that died, zero otherwise
+    xbool timed_out; // Set when a snapshot child was killed for running too long
+} xresult;
+#endif
+
+#if defined(XTEST_ASYNC_LOOP)
+// Stack size of each async coroutine, the lowest page is left as a guard
+#define XTEST_ASYNC_STACK (256 * 1024)
+
+// Number of async test cases the event loop keeps in flight at once
+#define XTEST_ASYNC_LIMIT 4096
+
+// Async test case in flight on the event loop
+typedef struct {
+    uint32_t index;     // Index of the test case in the registry
+    ucontext_t context; // Saved registers of the coroutine while suspended
+    void* stack;        // Stack the coroutine runs on
+    xcontext state;     // Assert context of the test case while suspended
+    xtest* running;     // Test case XTEST_RUNNING names while it is resumed
+    xmark_timer timer;  // Benchmark timer of the test case while suspended
+    xmark_processed processed; // Throughput of the test case while suspended
+    xmark_budget budget;       // Allocation budget of the test case while suspended
+    xbool warned;       // Set once the test case got the timer overhead notice
+    int fd;             // Duplicate of the awaited descriptor, -1 when none
+    int ready;          // XTEST_AWAIT_* events reported by the loop
+    clock_t wake;       // When XTEST_AWAIT_MS returns, zero when not sleeping
+    clock_t deadline;   // When the test case times out, zero when never
+    xbool runnable;     // Set when the coroutine can be resumed
+    xbool finished;     // Set once the test case body has returned
+} xcoroutine;
+
+// Event loop running the async test cases on one thread
+typedef struct {
+    int epoll_fd;        // Descriptors awaited by the coroutines
+    ucontext_t context;  // Context of the loop, coroutines yield back to it
+    xcoroutine* current; // Coroutine running right now, xnullptr in the loop
+    xworker* worker;     // Scoreboard of the async test cases
+} xloop;
 
-static uint8_t MAX_REPEATS = 100;
-static uint8_t MIN_REPEATS = 1;
+static XTEST_THREAD_LOCAL xloop* XTEST_LOOP = xnullptr;
+#endif
 
 // Running tests in a queue
 void xtest_run_queue(xengine* engine);
@@ -47,11 +541,10 @@ void xtest_run_queue(xengine* engine);
 //
 // local types
 //
-static uint64_t start_time;
 
-#if defined(_WIN32)
-static double frequency; // Variable to store the frequency for Windows
-#endif
+// Timer of XMARK_START_BENCHMARK and XMARK_STOP_BENCHMARK, one per thread so
+// marks running on different workers keep their own start
+static XTEST_THREAD_LOCAL xmark_timer XMARK_TIMER = {0, 0};
 
 // ==============================================================================
 // Xtest internal console stream logic
@@ -103,13 +596,49 @@ static xstring replace_underscore(const xstring str) {
     return result;
 }
 
+// Wall clock reading scaled to clock() ticks, clock() counts processor time
+// for the whole process which no longer matches elapsed time once several
+// worker threads are running test cases at the same time.
+static clock_t xtest_clock(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (clock_t)((now.QuadPart / freq.QuadPart) * CLOCKS_PER_SEC + ((now.QuadPart % freq.QuadPart) * CLOCKS_PER_SEC) / freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (clock_t)(ts.tv_sec * CLOCKS_PER_SEC + ts.tv_nsec / (1000000000 / CLOCKS_PER_SEC));
+#endif
+}
+
+// Monotonic clock in nanoseconds, fine grained enough to time one body run
+static uint64_t xtest_nanos(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)((now.QuadPart / freq.QuadPart) * 1000000000ULL + ((now.QuadPart % freq.QuadPart) * 1000000000ULL) / freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
 // printf has its use cases but to handle multable general purpose features without
 // forgetting to change a printf this would servse as the internal prinf with color
 // and potintal for additnal output releated functionality.
 static void xconsole_out(const xstring color_name, const xstring format, ...) {
     va_list args;
     va_start(args, format);
-    
+
+#if !defined(_WIN32)
+    flockfile(stdout); // keep color codes and text together across workers
+#endif
+
     if (xcli.color) {
         xstring color_code = "";
         
@@ -138,6 +667,10 @@ static void xconsole_out(const xstring color_name, const xstring format, ...) {
         vprintf(format, args);
     }
 
+#if !defined(_WIN32)
+    funlockfile(stdout);
+#endif
+
     va_end(args);
 }
 
@@ -226,7 +759,7 @@ const xstring helpful_tester_tip() {
 // ==============================================================================
 
 // Formats and displays information about the start/end of a test case.
-static void output_start_test(xtest *test_case, xengine* engine) {
+static void output_start_test(xtest *test_case, xworker* worker) {
     if (xcli.debug) {
         xconsole_out("purple", "DEBUG: operator in: %s\n", __func__); 
     }
@@ -234,7 +767,7 @@ static void output_start_test(xtest *test_case, xengine* engine) {
     if (xcli.verbose && !xcli.cutback) {
         xconsole_out("blue", "[...start...]\n");
         xconsole_out("cyan", ".\t> TITLE: - %s\n", replace_underscore(test_case->name));
-        xconsole_out("cyan", ".\t> INDEX: - %.2i\n", engine->stats.total_count + 1);
+        xconsole_out("cyan", ".\t> INDEX: - %.2u\n", worker->engine->stats.total_count + worker->stats.total_count + 1);
         xconsole_out("cyan", ".\t> CLASS: - %s\n", (test_case->config.is_fish)? "Fish AI" : (test_case->config.is_mark)? "Benchmark" : "Test Case");
     } else if (!xcli.cutback && !xcli.verbose) {
         xconsole_out("blue", "> name: - %s\n", replace_underscore(test_case->name));
@@ -246,12 +779,12 @@ static void output_start_test(xtest *test_case, xengine* engine) {
     }
 } // end of func
 
-static void output_end_test(xtest *test_case, xengine* engine) {
+static void output_end_test(xtest *test_case) {
     if (xcli.debug) {
         xconsole_out("purple", "DEBUG: operator in: %s\n", __func__); 
     }
 
-    test_case->timer.end = clock();
+    test_case->timer.end = xtest_clock();
     test_case->timer.elapsed = test_case->timer.end - test_case->timer.start;
 
     int64_t minutes      = (int64_t)(test_case->timer.elapsed / (60 * CLOCKS_PER_SEC));
@@ -279,7 +812,7 @@ static void output_summary_format(xengine *runner) {
         xconsole_out("purple", "DEBUG: operator in: %s\n", __func__); 
     }
 
-    runner->timer.end = clock();
+    runner->timer.end = xtest_clock();
     runner->timer.elapsed = runner->timer.end - runner->timer.start;
 
     int64_t minutes      = (int64_t)(runner->timer.elapsed / (60 * CLOCKS_PER_SEC));
@@ -290,14 +823,48 @@ static void output_summary_format(xengine *runner) {
     xconsole_out("blue", "[Test Summary: Fossil Test]: %lld minutes, %lld seconds, %lld milliseconds, %lld microseconds\n", minutes, seconds, millis, microseconds);
     xconsole_out("blue", "***************************: %s\n", current_datetime());
 
-    if (runner->stats.total_count > 0) {
-        xconsole_out("cyan", "> - All Passed  : - %.2i\n",    runner->stats.passed_count);
-        xconsole_out("cyan", "> - All Failed  : - %.2i\n",    runner->stats.failed_count);
-        xconsole_out("cyan", "> - All Skipped : - %.2i\n",    runner->stats.ignored_count);
-        xconsole_out("cyan", "> - All Error   : - %.2i\n",    runner->stats.error_count);
-        xconsole_out("cyan", "> - Benchmark   : - %.2i\n",    runner->stats.mark_count);
-        xconsole_out("cyan", "> - Jellyfish AI: - %.2i\n",   runner->stats.fish_count);
-        xconsole_out("orange",  "> - Total Cases : - %.2i\n", runner->stats.total_count);
+    // timed out and crashed test cases are errors, they are not in the total
+    if (runner->stats.total_count > 0 || runner->stats.error_count > 0) {
+        xconsole_out("cyan", "> - All Passed  : - %.2u\n",    runner->stats.passed_count);
+        xconsole_out("cyan", "> - All Failed  : - %.2u\n",    runner->stats.failed_count);
+        xconsole_out("cyan", "> - All Skipped : - %.2u\n",    runner->stats.ignored_count);
+        xconsole_out("cyan", "> - All Error   : - %.2u\n",    runner->stats.error_count);
+        xconsole_out("cyan", "> - Benchmark   : - %.2u\n",    runner->stats.mark_count);
+        xconsole_out("cyan", "> - Jellyfish AI: - %.2u\n",   runner->stats.fish_count);
+        xconsole_out("orange",  "> - Total Cases : - %.2u\n", runner->stats.total_count);
+        if (xcli.shard_count > 1) {
+            xconsole_out("orange",  "> - Shard       : - %u/%u\n", xcli.shard_index, xcli.shard_count);
+        }
+        if (xcli.fail_fast > 0) {
+            xconsole_out("orange",  "> - Not Run     : - %.2u\n", runner->stats.unrun_count);
+        }
+        uint32_t unqueued = xtest_count_unqueued();
+        if (unqueued > 0) {
+            xconsole_out("orange",  "> - Unqueued    : - %.2u (defined but never queued, see XTEST_IMPORT_ALL)\n", unqueued);
+        }
+        if (xcli.shuffle) {
+            xconsole_out("orange",  "> - Shuffle Seed: - %llu\n", (unsigned long long)xcli.shuffle_seed);
+        }
+        if (XSHUFFLE.runs > 1) {
+            xconsole_out("orange",  "> - Orders Run  : - %.2u (%u order dependent)\n", XSHUFFLE.runs, XSHUFFLE.dependent);
+        }
+        if (xcli.repeat_for > 0.0 && XSOAK.rounds > 1) {
+            xconsole_out("orange",  "> - Soak Rounds : - %.2u\n", XSOAK.rounds);
+        }
+        if (xcli.mark_clock == XMARK_CLOCK_TSC && runner->stats.mark_count > 0) {
+            xconsole_out("orange",  "> - Mark Clock  : - tsc at %.3f GHz\n", 1.0 / XMARK_TICK_NS);
+        } else if (xcli.mark_clock != XMARK_CLOCK_MONOTONIC && runner->stats.mark_count > 0) {
+            xconsole_out("orange",  "> - Mark Clock  : - %s\n", xcli.mark_clock == XMARK_CLOCK_RAW ? "raw" : "thread-cpu");
+        }
+        if (xcli.mark_compare) {
+            xconsole_out(XMARK_REGRESSIONS ? "red" : "orange",  "> - Regressions : - %.2u\n", XMARK_REGRESSIONS);
+        }
+        if (XTEST_FILTERED > 0) {
+            xconsole_out("orange",  "> - Filtered    : - %.2u\n", XTEST_FILTERED);
+        }
+        if (XFIXTURE_SETUPS > 0) {
+            xconsole_out("cyan", "> - Fixture Set : - %.2u (%lld milliseconds)\n", XFIXTURE_SETUPS, (int64_t)(XFIXTURE_TIME * 1000 / CLOCKS_PER_SEC));
+        }
     } else {
         xconsole_out("cyan", "\n\n\n%s\n\n\n\n\n", empty_runner_comment());
     }
@@ -325,7 +892,7 @@ void output_assert_format(const xstring message, const xstring file, int line, c
     } else if (xcli.cutback && !xcli.verbose) {
         xconsole_out("red", "[F]");
     }
-    XTEST_PASS_SCAN = xfalse;
+    XTEST_CONTEXT.pass_scan = xfalse;
     if (xcli.debug) {
         xconsole_out("purple", "DEBUG: operator leaving: %s\n", __func__); 
     }
@@ -347,8 +914,8 @@ void output_assume_format(const xstring message, const xstring file, int line, c
     } else if (xcli.cutback && !xcli.verbose) {
         xconsole_out("red", "[F]");
     }
-    ASSUME_ISSUES++;
-    XTEST_PASS_SCAN = xfalse;
+    XTEST_CONTEXT.assume_issues++;
+    XTEST_CONTEXT.pass_scan = xfalse;
     if (xcli.debug) {
         xconsole_out("purple", "DEBUG: operator leaving: %s\n", __func__); 
     }
@@ -370,7 +937,7 @@ void output_expect_format(const xstring message, const xstring file, int line, c
     } else if (xcli.cutback && !xcli.verbose) {
         xconsole_out("red", "[F]");
     }
-    XTEST_PASS_SCAN = xfalse;
+    XTEST_CONTEXT.pass_scan = xfalse;
     if (xcli.debug) {
         xconsole_out("purple", "DEBUG: operator leaving: %s\n", __func__); 
     }
@@ -391,7 +958,7 @@ void output_xerrors_format(const xstring reason, const xstring file, int line, c
     } else if (xcli.cutback && !xcli.verbose) {
         xconsole_out("orange", "[F]");
     }
-    XERRORS_TEST_CASE = xtrue;
+    XTEST_CONTEXT.errors_case = xtrue;
 
     if (xcli.debug) {
         xconsole_out("purple", "DEBUG: operator leaving: %s\n", __func__); 
@@ -413,14 +980,14 @@ void output_xignore_format(const xstring reason, const xstring file, int line, c
     } else if (xcli.cutback && !xcli.verbose) {
         xconsole_out("yellow", "[S]");
     }
-    XIGNORE_TEST_CASE = xtrue;
+    XTEST_CONTEXT.ignore_case = xtrue;
 
     if (xcli.debug) {
         xconsole_out("purple", "DEBUG: operator leaving: %s\n", __func__); 
     }
 }
 
-void output_benchmark_format(uint64_t elapsed, double max) {
+void output_benchmark_format(double elapsed, double max) {
     if (xcli.debug) {
         xconsole_out("purple", "DEBUG: operator in: %s\n", __func__); 
     }
@@ -434,177 +1001,3119 @@ void output_benchmark_format(uint64_t elapsed, double max) {
     } else if (xcli.cutback && !xcli.verbose) {
         xconsole_out("red", "[F]");
     }
-    XTEST_PASS_SCAN = xfalse;
+    XTEST_CONTEXT.pass_scan = xfalse;
 
     if (xcli.debug) {
         xconsole_out("purple", "DEBUG: operator leaving: %s\n", __func__); 
     }
 }
 
-// Prints usage instructions, including custom options, for a command-line program.
-static void output_usage_format(void) {
-    if (xcli.debug) {
-        xconsole_out("purple", "DEBUG: operator in: %s\n", __func__); 
+// Unit that keeps a time in nanoseconds between 1 and 1000, value is scaled to it
+static const char* xmark_unit(double nanos, double* value) {
+    static const char* units[] = {"ns", "us", "ms", "s"};
+    uint8_t unit = 0;
+    *value = nanos;
+    while (unit < 3 && (*value >= 1000.0 || *value <= -1000.0)) {
+        *value /= 1000.0;
+        unit++;
     }
+    return units[unit];
+}
 
-    xconsole_out("blue", "Usage: xcli [options] %s\n", current_datetime());
-    xconsole_out("blue", "Options:\n");
-    xconsole_out("cyan", "\t-h, --help   : Display this help message                             :\n");
-    xconsole_out("cyan", "\t-v, --version: Display program version                               :\n");
-    xconsole_out("cyan", "\t-t, --tip    : Display a helpful tip                                 :\n");
-    xconsole_out("cyan", "\t--cutback    : Enable cutback 50%% of output                         :\n");
-    xconsole_out("cyan", "\t--verbose    : Enable verbose mode for extra information             :\n");
-    xconsole_out("cyan", "\t--human      : Enable human format mode                              :\n");
-    xconsole_out("cyan", "\t--color      : Enable colored output                                 :\n");
-    xconsole_out("cyan", "\t--ci         : Enable CI pipeline optimizer to save time             :\n");
-    xconsole_out("cyan", "\t--only-test  : Run only test cases                                   :\n");
-    xconsole_out("cyan", "\t--only-fish  : Run only AI training cases                            :\n");
-    xconsole_out("cyan", "\t--only-mark  : Run only benchmark cases                              :\n");
-    xconsole_out("cyan", "\t--repeat N   : Repeat the test N times (requires a numeric argument) :\n");
-    xconsole_out("cyan", "\t--debug      : Enable debug mode\n");
+// Scales a rate per second to the largest unit that keeps it at or above one
+static const char* xmark_rate_unit(double per_second, const char* const* units, double* value) {
+    uint8_t unit = 0;
+    *value = per_second;
+    while (unit < 4 && *value >= 1000.0) {
+        *value /= 1000.0;
+        unit++;
+    }
+    return units[unit];
+}
 
+// Reports the statistics of a benchmark loop.
+static void output_mark_format(const xtest *test_case, const xmark_stats *stats) {
     if (xcli.debug) {
-        xconsole_out("purple", "DEBUG: operator leaving: %s\n", __func__); 
+        xconsole_out("purple", "DEBUG: operator in: %s\n", __func__); 
     }
-} // end of func
 
-// ==============================================================================
-// Xtest internal argument parser logic
-// ==============================================================================
+    const char* labels[] = {"min", "median", "mean", "stddev", "p90", "p99"};
+    double times[] = {stats->min, stats->median, stats->mean, stats->stddev, stats->p90, stats->p99};
+    if (xcli.verbose && !xcli.cutback) {
+        xconsole_out("blue", "[...benchmark...]\n");
+        xconsole_out("cyan", ".\t> MARK: - %s, %u samples of %llu iterations\n", test_case ? replace_underscore(test_case->name) : "loop", stats->samples, (unsigned long long)stats->batch);
+        for (uint8_t i = 0; i < 6; i++) {
+            double value = 0.0;
+            const char* unit = xmark_unit(times[i], &value);
+            xconsole_out("cyan", ".\t> %-6s: - %.2f %s\n", labels[i], value, unit);
+        }
+        xconsole_out("cyan", ".\t> outliers: - %u low, %u high\n", stats->low_outliers, stats->high_outliers);
+    } else if (!xcli.cutback && !xcli.verbose) {
+        xconsole_out("blue", "> mark     : - %u samples of %llu iterations\n", stats->samples, (unsigned long long)stats->batch);
+        for (uint8_t i = 0; i < 6; i++) {
+            double value = 0.0;
+            const char* unit = xmark_unit(times[i], &value);
+            xconsole_out("cyan", "> %-9s: - %.2f %s\n", labels[i], value, unit);
+        }
+        xconsole_out("cyan", "> outliers : - %u low, %u high\n", stats->low_outliers, stats->high_outliers);
+    }
 
-// Initialize queue
-xqueue* xqueue_create() {
-    xqueue* queue = (xqueue*)malloc(sizeof(xqueue));
-    if (!queue) {
-        return xnullptr;
+    // hardware counters per iteration, each only when the PMU counted it
+    const char* events[] = {"cycles", "instructions", "L1 misses", "LLC misses", "br misses"};
+    for (uint8_t i = 0; i < XMARK_COUNTERS && !xcli.cutback; i++) {
+        if (stats->counters[i] >= 0.0) {
+            xconsole_out("cyan", xcli.verbose ? ".\t> %-6s: - %.2f per iteration\n" : "> %-9s: - %.2f per iteration\n", events[i], stats->counters[i]);
+        }
+    }
+    if (!xcli.cutback && stats->counters[XMARK_CYCLES] > 0.0 && stats->counters[XMARK_INSTRUCTIONS] >= 0.0) {
+        xconsole_out("cyan", xcli.verbose ? ".\t> %-6s: - %.2f\n" : "> %-9s: - %.2f\n", "IPC", stats->counters[XMARK_INSTRUCTIONS] / stats->counters[XMARK_CYCLES]);
     }
-    queue->front = xnullptr;
-    queue->rear = xnullptr;
-    return queue;
-}
 
-// Check if queue is empty
-xbool xqueue_is_empty(xqueue* queue) {
-    return queue->front == xnullptr;
-}
+    // throughput at the median time per iteration
+    static const char* const byte_units[] = {"B/s", "KB/s", "MB/s", "GB/s", "TB/s"};
+    static const char* const item_units[] = {"items/s", "K items/s", "M items/s", "G items/s", "T items/s"};
+    if (!xcli.cutback && stats->median > 0.0 && stats->bytes > 0) {
+        double value = 0.0;
+        const char* unit = xmark_rate_unit((double)stats->bytes * 1e9 / stats->median, byte_units, &value);
+        xconsole_out("cyan", xcli.verbose ? ".\t> %-6s: - %.2f %s\n" : "> %-9s: - %.2f %s\n", "bytes", value, unit);
+    }
+    if (!xcli.cutback && stats->median > 0.0 && stats->items > 0) {
+        double value = 0.0;
+        const char* unit = xmark_rate_unit((double)stats->items * 1e9 / stats->median, item_units, &value);
+        xconsole_out("cyan", xcli.verbose ? ".\t> %-6s: - %.2f %s\n" : "> %-9s: - %.2f %s\n", "items", value, unit);
+    }
 
-// xqueue_enqueue an xtest node
-void xqueue_enqueue(xqueue* queue, xtest* test) {
-    test->next = xnullptr;
-    if (xqueue_is_empty(queue)) {
-        queue->front = test;
-        queue->rear = test;
-    } else {
-        queue->rear->next = test;
-        queue->rear = test;
+    // allocations per iteration, only in builds with the allocation hooks
+    if (!xcli.cutback && stats->allocs >= 0.0) {
+        xconsole_out("cyan", xcli.verbose ? ".\t> %-6s: - %.2f per iteration, %.2f frees\n" : "> %-9s: - %.2f per iteration, %.2f frees\n", "allocs", stats->allocs, stats->frees);
+        xconsole_out("cyan", xcli.verbose ? ".\t> %-6s: - %.2f bytes per iteration\n" : "> %-9s: - %.2f bytes per iteration\n", "heap", stats->allocated);
+    }
+
+    if (xcli.debug) {
+        xconsole_out("purple", "DEBUG: operator leaving: %s\n", __func__); 
     }
 }
 
-// xqueue_dequeue an xtest node
-xtest* xqueue_dequeue(xqueue* queue) {
-    if (xqueue_is_empty(queue)) {
-        return xnullptr;
+// Reports the median time of one input size of a range benchmark.
+static void output_range_format(uint64_t size, const xmark_stats *stats) {
+    if (xcli.debug) {
+        xconsole_out("purple", "DEBUG: operator in: %s\n", __func__); 
     }
-    xtest* temp = queue->front;
-    queue->front = queue->front->next;
-    if (queue->front == xnullptr) {
-        queue->rear = xnullptr;
+
+    double value = 0.0;
+    const char* unit = xmark_unit(stats->median, &value);
+    double spread = 0.0;
+    const char* spread_unit = xmark_unit(stats->stddev, &spread);
+    if (xcli.verbose && !xcli.cutback) {
+        xconsole_out("cyan", ".\t> n = %-8llu: - %.2f %s +/- %.2f %s, %u samples of %llu iterations\n", (unsigned long long)size,
+                     value, unit, spread, spread_unit, stats->samples, (unsigned long long)stats->batch);
+    } else if (!xcli.cutback && !xcli.verbose) {
+        xconsole_out("cyan", "> n = %-8llu: - %.2f %s +/- %.2f %s\n", (unsigned long long)size, value, unit, spread, spread_unit);
     }
-    temp->next = xnullptr;
-    return temp;
-}
 
-// Erase the queue
-void xqueue_erase(xqueue* queue) {
-    while (!xqueue_is_empty(queue)) {
-        xtest* current_test = xqueue_dequeue(queue);
-        if (current_test != xnullptr) {
-            free(current_test); // Free memory allocated for dequeued test case
-        }
+    if (xcli.debug) {
+        xconsole_out("purple", "DEBUG: operator leaving: %s\n", __func__); 
     }
 }
 
-// ==============================================================================
-// Xtest basic utility functions
-// ==============================================================================
-
-// Updates the statistics
-static void xtest_update_scoreboard(xengine* engine, xtest* test_case) {
-    // Check if the test should be ignored
-    if (test_case->config.ignored) {
-        engine->stats.ignored_count++;
-        return;
+// Reports the complexity that fits the timings of a range benchmark best.
+static void output_complexity_format(const char* complexity, const char* term, double coefficient, double rms) {
+    if (xcli.debug) {
+        xconsole_out("purple", "DEBUG: operator in: %s\n", __func__); 
     }
-    if (XERRORS_TEST_CASE) {
-        engine->stats.error_count++;
-        return;
+
+    double value = 0.0;
+    const char* unit = xmark_unit(coefficient, &value);
+    if (xcli.verbose && !xcli.cutback) {
+        xconsole_out("blue", ".\t> complexity: - %s, %.3f %s%s, rms %.1f%%\n", complexity, value, unit, term, rms * 100.0);
+    } else if (!xcli.cutback && !xcli.verbose) {
+        xconsole_out("blue", "> complexity: - %s, %.3f %s%s, rms %.1f%%\n", complexity, value, unit, term, rms * 100.0);
     }
 
-    // Update the appropriate count based on your logic
-    if (!test_case->config.is_mark && !test_case->config.is_fish) {
-        engine->stats.test_count++;
-    } else if (test_case->config.is_fish && !test_case->config.is_mark) {
-        engine->stats.fish_count++;
-    } else if (test_case->config.is_mark && !test_case->config.is_fish) {
-        engine->stats.mark_count++;
+    if (xcli.debug) {
+        xconsole_out("purple", "DEBUG: operator leaving: %s\n", __func__); 
     }
+}
 
-    // Update main score values
-    if (!XTEST_PASS_SCAN) {
-        engine->stats.failed_count++;
-    } else {
-        engine->stats.passed_count++;
+#if !defined(_WIN32)
+// Reports a test case that took its worker process down with it.
+static void output_crash_format(xtest *test_case, int status) {
+    if (xcli.debug) {
+        xconsole_out("purple", "DEBUG: operator in: %s\n", __func__); 
     }
-    engine->stats.total_count++;
-} // end of func
 
-// Core steps to run a test case
-static void xtest_run(xtest* test_case, xfixture* fixture) {
-    for (uint8_t iter = 0; iter < xcli.iter_repeat; iter++) {
-        if (fixture && fixture->setup) {
-            fixture->setup();
+    if (xcli.verbose && !xcli.cutback) {
+        xconsole_out("blue", "***************************:\n");
+        xconsole_out("orange", " .\n\t> Test crashed: %s\n", replace_underscore(test_case->name));
+        if (WIFSIGNALED(status)) {
+            xconsole_out("orange", " .\n\t> Signal: %d (%s)\n", WTERMSIG(status), strsignal(WTERMSIG(status)));
+        } else {
+            xconsole_out("orange", " .\n\t> Exit status: %d\n", WEXITSTATUS(status));
         }
-
-        test_case->test_function();
-
-        if (fixture && fixture->teardown) {
-            fixture->teardown();
+    } else if (!xcli.cutback && !xcli.verbose) {
+        if (WIFSIGNALED(status)) {
+            xconsole_out("orange", "Test crashed: %s, signal %d (%s)\n", test_case->name, WTERMSIG(status), strsignal(WTERMSIG(status)));
+        } else {
+            xconsole_out("orange", "Test crashed: %s, exit status %d\n", test_case->name, WEXITSTATUS(status));
         }
+    } else if (xcli.cutback && !xcli.verbose) {
+        xconsole_out("orange", "[E]");
     }
-} // end of func
-
-// Common functionality for running a test case.
-static void xtest_run_test(xengine* engine, xtest* test_case, xfixture* fixture) {
-    output_start_test(test_case, engine);
 
-    if (!xcli.dry_run && !XIGNORE_TEST_CASE) {
-        xtest_run(test_case, fixture);
-
-    } else if (!xcli.dry_run && XIGNORE_TEST_CASE) {
-        test_case->config.ignored = XIGNORE_TEST_CASE;
-        XIGNORE_TEST_CASE = xfalse;
+    if (xcli.debug) {
+        xconsole_out("purple", "DEBUG: operator leaving: %s\n", __func__); 
+    }
+}
+#endif
 
-    } else if (xcli.dry_run) {
-        xconsole_out("blue", "Simulating test case...\n");
-        return;
+// Reports a test case that was given up on by the watchdog.
+static void output_timeout_format(xtest *test_case, uint32_t timeout) {
+    if (xcli.debug) {
+        xconsole_out("purple", "DEBUG: operator in: %s\n", __func__); 
     }
 
-    xtest_update_scoreboard(engine, test_case);
-    output_end_test(test_case, engine);
-} // end of func
+    if (xcli.verbose && !xcli.cutback) {
+        xconsole_out("blue", "***************************:\n");
+        xconsole_out("orange", " .\n\t> Test timed out: %s\n", replace_underscore(test_case->name));
+        xconsole_out("orange", " .\n\t> Limit: %u milliseconds\n", timeout);
+    } else if (!xcli.cutback && !xcli.verbose) {
+        xconsole_out("orange", "Test timed out: %s, limit %u milliseconds\n", test_case->name, timeout);
+    } else if (xcli.cutback && !xcli.verbose) {
+        xconsole_out("orange", "[E]");
+    }
+
+    if (xcli.debug) {
+        xconsole_out("purple", "DEBUG: operator leaving: %s\n", __func__); 
+    }
+}
+
+// Reports a test case skipped because one of its prerequisites did not pass.
+static void output_blocked_format(xtest *test_case, xtest *prerequisite) {
+    if (xcli.debug) {
+        xconsole_out("purple", "DEBUG: operator in: %s\n", __func__); 
+    }
+
+    if (xcli.verbose && !xcli.cutback) {
+        xconsole_out("blue", "***************************:\n");
+        xconsole_out("yellow", " .\n\t> Test skipped: %s\n", replace_underscore(test_case->name));
+        xconsole_out("yellow", " .\n\t> Prerequisite did not pass: %s\n", prerequisite->name);
+    } else if (!xcli.cutback && !xcli.verbose) {
+        xconsole_out("yellow", "Test skipped: %s, prerequisite %s did not pass\n", test_case->name, prerequisite->name);
+    } else if (xcli.cutback && !xcli.verbose) {
+        xconsole_out("yellow", "[S]");
+    }
+
+    if (xcli.debug) {
+        xconsole_out("purple", "DEBUG: operator leaving: %s\n", __func__); 
+    }
+}
+
+// Prints usage instructions, including custom options, for a command-line program.
+static void output_usage_format(void) {
+    if (xcli.debug) {
+        xconsole_out("purple", "DEBUG: operator in: %s\n", __func__); 
+    }
+
+    xconsole_out("blue", "Usage: xcli [options] %s\n", current_datetime());
+    xconsole_out("blue", "Options:\n");
+    xconsole_out("cyan", "\t-h, --help   : Display this help message                             :\n");
+    xconsole_out("cyan", "\t-v, --version: Display program version                               :\n");
+    xconsole_out("cyan", "\t-t, --tip    : Display a helpful tip                                 :\n");
+    xconsole_out("cyan", "\t--cutback    : Enable cutback 50%% of output                         :\n");
+    xconsole_out("cyan", "\t--verbose    : Enable verbose mode for extra information             :\n");
+    xconsole_out("cyan", "\t--human      : Enable human format mode                              :\n");
+    xconsole_out("cyan", "\t--color      : Enable colored output                                 :\n");
+    xconsole_out("cyan", "\t--ci         : Enable CI pipeline optimizer to save time             :\n");
+    xconsole_out("cyan", "\t--only-test  : Run only test cases                                   :\n");
+    xconsole_out("cyan", "\t--only-fish  : Run only AI training cases                            :\n");
+    xconsole_out("cyan", "\t--only-mark  : Run only benchmark cases                              :\n");
+    xconsole_out("cyan", "\t--repeat N   : Repeat the test N times (requires a numeric argument) :\n");
+    xconsole_out("cyan", "\t--repeat-for D: Soak, rerun the tests on all cores for D (2h, 30m, 10s):\n");
+    xconsole_out("cyan", "\t--jobs N     : Run test cases on N worker threads (0 uses all cores) :\n");
+    xconsole_out("cyan", "\t--isolate=fork: Run test cases in a pool of N worker processes       :\n");
+    xconsole_out("cyan", "\t--history F  : Record durations in F and run the slowest cases first :\n");
+    xconsole_out("cyan", "\t--default-cost MS: Estimated duration of cases missing from history :\n");
+    xconsole_out("cyan", "\t--shard I/N  : Run shard I of N, by --history durations or by count :\n");
+    xconsole_out("cyan", "\t--fail-fast[=K]: Stop running test cases after K failures (default 1):\n");
+    xconsole_out("cyan", "\t--timeout MS : Error out test cases running longer than MS          :\n");
+    xconsole_out("cyan", "\t--filter P   : Run only test cases matching glob or /regex/ P       :\n");
+    xconsole_out("cyan", "\t--exclude P  : Skip test cases matching glob or /regex/ P           :\n");
+    xconsole_out("cyan", "\t--shuffle[=S]: Run the test cases in a random order drawn from seed S  :\n");
+    xconsole_out("cyan", "\t--shuffle-runs K: Run K shuffled orders and report order dependent cases:\n");
+    xconsole_out("cyan", "\t--mark-time MS: Time XMARK_LOOP spends sampling each benchmark       :\n");
+    xconsole_out("cyan", "\t--mark-samples N: Samples XMARK_LOOP takes per benchmark (5 to 1000)  :\n");
+    xconsole_out("cyan", "\t--mark-counters: Count cycles, instructions and misses in XMARK_LOOP :\n");
+    xconsole_out("cyan", "\t--mark-clock=C: Time benchmarks with tsc, monotonic, raw or thread-cpu:\n");
+    xconsole_out("cyan", "\t--mark-save-baseline F: Save the benchmark samples of this run in F  :\n");
+    xconsole_out("cyan", "\t--mark-compare F: Fail benchmarks that regressed against baseline F  :\n");
+    xconsole_out("cyan", "\t--mark-threshold PCT: Slowdown a regression must exceed (default 5)  :\n");
+    xconsole_out("cyan", "\t--debug      : Enable debug mode\n");
+
+    if (xcli.debug) {
+        xconsole_out("purple", "DEBUG: operator leaving: %s\n", __func__); 
+    }
+} // end of func
+
+// ==============================================================================
+// Xtest test registry
+// ==============================================================================
+
+// Grows both arrays of the registry to hold at least capacity test cases
+static void xregistry_reserve(xregistry* registry, uint32_t capacity) {
+    if (capacity <= registry->capacity) {
+        return;
+    }
+    xentry* entries = (xentry*)realloc(registry->entries, capacity * sizeof(xentry));
+    if (entries) {
+        registry->entries = entries;
+    }
+    xtest** tests = (xtest**)realloc(registry->tests, capacity * sizeof(xtest*));
+    if (tests) {
+        registry->tests = tests;
+    }
+    if (!entries || !tests) {
+        xconsole_out("red", "Error: unable to allocate the test registry.\n");
+        exit(EXIT_FAILURE);
+    }
+    registry->capacity = capacity;
+}
+
+// Fills the next slot of the registry, the caller has reserved it
+static void xregistry_store(xregistry* registry, xtest* test_case) {
+    xentry* entry = &registry->entries[registry->count];
+    entry->test_function = test_case->test_function;
+    entry->timeout       = test_case->config.timeout;
+    entry->flags         = (test_case->config.ignored ? XTEST_FLAG_IGNORED : 0)
+                         | (test_case->config.is_mark ? XTEST_FLAG_MARK : 0)
+                         | (test_case->config.is_fish ? XTEST_FLAG_FISH : 0)
+                         | (test_case->fixture.shared ? XTEST_FLAG_SHARED : 0)
+                         | (test_case->config.is_async ? XTEST_FLAG_ASYNC : 0)
+#if !defined(_WIN32)
+                         | (test_case->fixture.snapshot ? XTEST_FLAG_SNAPSHOT : 0)
+#endif
+                         ;
+    registry->tests[registry->count++] = test_case;
+}
+
+// Appends a test case to the registry, both arrays grow together
+static void xregistry_push(xregistry* registry, xtest* test_case) {
+    if (registry->count == registry->capacity) {
+        xregistry_reserve(registry, registry->capacity ? registry->capacity * 2 : 64);
+    }
+    xregistry_store(registry, test_case);
+}
+
+// Rebuilds the registry in the given order of indices, indices left out of
+// the order are dropped from the registry
+static void xregistry_reorder(xregistry* registry, const uint32_t* order, uint32_t count) {
+    xentry* entries = (xentry*)malloc((count ? count : 1) * sizeof(xentry));
+    xtest** tests = (xtest**)malloc((count ? count : 1) * sizeof(xtest*));
+    if (!entries || !tests) {
+        xconsole_out("red", "Error: unable to allocate the test registry.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        entries[i] = registry->entries[order[i]];
+        tests[i]   = registry->tests[order[i]];
+    }
+    free(registry->entries);
+    free(registry->tests);
+    registry->entries  = entries;
+    registry->tests    = tests;
+    registry->count    = count;
+    registry->capacity = count ? count : 1;
+}
+
+// Erase the registry, the test cases themselves are owned by their modules
+static void xregistry_erase(xregistry* registry) {
+    free(registry->entries);
+    free(registry->tests);
+    *registry = (xregistry){xnullptr, xnullptr, 0, 0};
+}
+
+// Check if deque is empty
+static xbool xdeque_is_empty(const xdeque* deque) {
+    return deque->head == deque->tail;
+}
+
+// Appends an index at the tail of a deque, growing it as needed
+static void xdeque_push(xdeque* deque, uint32_t index) {
+    if (xdeque_is_empty(deque)) {
+        deque->head = 0;
+        deque->tail = 0;
+    }
+    if (deque->tail == deque->capacity) {
+        uint32_t capacity = deque->capacity ? deque->capacity * 2 : 16;
+        uint32_t* slots = (uint32_t*)realloc(deque->slots, capacity * sizeof(uint32_t));
+        if (!slots) {
+            xconsole_out("red", "Error: unable to allocate a worker deque.\n");
+            exit(EXIT_FAILURE);
+        }
+        deque->slots = slots;
+        deque->capacity = capacity;
+    }
+    deque->slots[deque->tail++] = index;
+}
+
+// Pops the index at the tail of a deque, XTEST_NONE when empty
+static uint32_t xdeque_pop_tail(xdeque* deque) {
+    return xdeque_is_empty(deque) ? XTEST_NONE : deque->slots[--deque->tail];
+}
+
+// Takes the index at the head of a deque, XTEST_NONE when empty
+static uint32_t xdeque_pop_head(xdeque* deque) {
+    return xdeque_is_empty(deque) ? XTEST_NONE : deque->slots[deque->head++];
+}
+
+// Index at the head of a deque, XTEST_NONE when empty
+static uint32_t xdeque_peek_head(const xdeque* deque) {
+    return xdeque_is_empty(deque) ? XTEST_NONE : deque->slots[deque->head];
+}
+
+// ==============================================================================
+// Xtest run history
+// ==============================================================================
+
+// FNV-1a hash of a test case name
+static uint64_t xhistory_hash(const char* name) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (; *name; name++) {
+        hash ^= (unsigned char)*name;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Finds the slot holding a name, or the empty slot where it would go
+static xhistory_entry* xhistory_slot(xhistory* history, const char* name) {
+    size_t mask = history->capacity - 1;
+    size_t index = (size_t)xhistory_hash(name) & mask;
+    while (history->entries[index].name != xnullptr && strcmp(history->entries[index].name, name) != 0) {
+        index = (index + 1) & mask;
+    }
+    return &history->entries[index];
+}
+
+// Records the duration of a test case, growing the table as needed
+static void xhistory_store(xhistory* history, const char* name, uint64_t cost) {
+    if ((history->count + 1) * 10 >= history->capacity * 7) {
+        size_t old_capacity = history->capacity;
+        xhistory_entry* old_entries = history->entries;
+
+        history->capacity = old_capacity ? old_capacity * 2 : 64;
+        history->entries = (xhistory_entry*)calloc(history->capacity, sizeof(xhistory_entry));
+        if (!history->entries) {
+            xconsole_out("red", "Error: unable to allocate the run history.\n");
+            exit(EXIT_FAILURE);
+        }
+        for (size_t i = 0; i < old_capacity; i++) {
+            if (old_entries[i].name != xnullptr) {
+                *xhistory_slot(history, old_entries[i].name) = old_entries[i];
+            }
+        }
+        free(old_entries);
+    }
+
+    xhistory_entry* entry = xhistory_slot(history, name);
+    if (entry->name == xnullptr) {
+        entry->name = xstrdup((const xstring)name);
+        history->count++;
+    }
+    entry->cost = cost;
+}
+
+// Looks up the duration of a test case, unknown cases cost --default-cost
+static uint64_t xhistory_cost(xhistory* history, const char* name) {
+    if (history->capacity > 0) {
+        xhistory_entry* entry = xhistory_slot(history, name);
+        if (entry->name != xnullptr) {
+            return entry->cost;
+        }
+    }
+    return (uint64_t)(xcli.default_cost * 1000.0);
+}
+
+// Loads durations recorded by earlier runs, a missing file is an empty history
+static void xhistory_load(xhistory* history, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return;
+    }
+
+    char line[512];
+    while (fgets(line, sizeof(line), file)) {
+        char name[sizeof(line)];
+        unsigned long long cost;
+        if (line[0] != '#' && sscanf(line, "%511s %llu", name, &cost) == 2) {
+            xhistory_store(history, name, (uint64_t)cost);
+        }
+    }
+    fclose(file);
+}
+
+// Writes every known duration back, including cases that did not run this time
+static void xhistory_save(xhistory* history, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        xconsole_out("orange", "Notice: unable to write history file %s\n", path);
+        return;
+    }
+
+    fprintf(file, "# xtest history: <name> <microseconds>\n");
+    for (size_t i = 0; i < history->capacity; i++) {
+        if (history->entries[i].name != xnullptr) {
+            fprintf(file, "%s %llu\n", history->entries[i].name, (unsigned long long)history->entries[i].cost);
+        }
+    }
+    fclose(file);
+}
+
+// Test case paired with its expected duration, used for ordering
+typedef struct {
+    uint64_t cost;    // Expected duration in microseconds
+    uint32_t order;   // Index in the registry, keeps the sort stable
+} xcost;
+
+static int xcost_compare_longest(const void* lhs, const void* rhs) {
+    const xcost* a = (const xcost*)lhs;
+    const xcost* b = (const xcost*)rhs;
+    if (a->cost != b->cost) {
+        return (a->cost < b->cost) ? 1 : -1;
+    }
+    return (a->order > b->order) - (a->order < b->order);
+}
+
+// Expected durations of every queued test case sorted longest first
+static xcost* xhistory_costs(xhistory* history, xregistry* registry) {
+    xcost* costs = (xcost*)malloc((registry->count ? registry->count : 1) * sizeof(xcost));
+    if (!costs) {
+        return xnullptr;
+    }
+    for (uint32_t i = 0; i < registry->count; i++) {
+        costs[i] = (xcost){xhistory_cost(history, registry->tests[i]->name), i};
+    }
+    qsort(costs, registry->count, sizeof(xcost), xcost_compare_longest);
+    return costs;
+}
+
+// Orders the test cases longest first so the last case handed out to the
+// workers is a short one and the run ends close to total time / jobs.
+static void xhistory_sort_longest_first(xhistory* history, xregistry* registry) {
+    xcost* costs = xhistory_costs(history, registry);
+    uint32_t* order = (uint32_t*)malloc((registry->count ? registry->count : 1) * sizeof(uint32_t));
+    if (!costs || !order) {
+        free(costs);
+        free(order);
+        return; // keep registration order
+    }
+
+    for (uint32_t i = 0; i < registry->count; i++) {
+        order[i] = costs[i].order;
+    }
+    xregistry_reorder(registry, order, registry->count);
+    free(order);
+    free(costs);
+}
+
+// Keeps only the test cases of shard --shard I/N. Cases are handed out longest
+// first to whichever shard has the least recorded time so far, without a
+// history every case costs --default-cost so they split by count. Every process
+// sees the same history and registration order so they agree on the split.
+// Test cases linked by XTEST_DEPENDS_ON go to the same shard as one group.
+static void xhistory_select_shard(xhistory* history, xregistry* registry, uint32_t index, uint32_t shards) {
+    uint32_t count = registry->count;
+    xcost* costs = xhistory_costs(history, registry);
+    uint32_t* groups = xgraph_groups(registry);
+    uint64_t* weights = (uint64_t*)calloc(count ? count : 1, sizeof(uint64_t));
+    uint64_t* loads = (uint64_t*)calloc(shards, sizeof(uint64_t));
+    uint8_t* keep = (uint8_t*)calloc(count ? count : 1, sizeof(uint8_t));
+    uint32_t* order = (uint32_t*)malloc((count ? count : 1) * sizeof(uint32_t));
+    if (!costs || !weights || !loads || !keep || !order) {
+        xconsole_out("red", "Error: unable to allocate the shard table.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // every case counts for at least a microsecond so free cases spread out
+    for (uint32_t i = 0; i < count; i++) {
+        weights[groups[costs[i].order]] += costs[i].cost ? costs[i].cost : 1;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t root = costs[i].order;
+        if (groups[root] != root) {
+            continue; // handed out with its group
+        }
+        uint32_t lightest = 0;
+        for (uint32_t k = 1; k < shards; k++) {
+            if (loads[k] < loads[lightest]) {
+                lightest = k;
+            }
+        }
+        loads[lightest] += weights[root];
+        keep[root] = (lightest == index - 1);
+    }
+
+    // the kept cases stay in registration order
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (keep[groups[i]]) {
+            order[kept++] = i;
+        }
+    }
+    xregistry_reorder(registry, order, kept);
+
+    free(order);
+    free(keep);
+    free(loads);
+    free(weights);
+    free(groups);
+    free(costs);
+}
+
+// Two fixtures are the same when they share their setup and teardown
+static xbool xfixture_same(const xfixture* lhs, const xfixture* rhs) {
+    return lhs->setup == rhs->setup && lhs->teardown == rhs->teardown;
+}
+
+// Test case paired with the position its fixture group is anchored at
+typedef struct {
+    xfixture fixture; // Fixture of the test case
+    uint32_t anchor;  // Position of the first case of its group
+    uint32_t order;   // Index in the registry, keeps the sort stable
+} xanchor;
+
+static int xanchor_compare_fixture(const void* lhs, const void* rhs) {
+    const xfixture* a = &((const xanchor*)lhs)->fixture;
+    const xfixture* b = &((const xanchor*)rhs)->fixture;
+    if (a->setup != b->setup) {
+        return ((uintptr_t)a->setup < (uintptr_t)b->setup) ? -1 : 1;
+    }
+    if (a->teardown != b->teardown) {
+        return ((uintptr_t)a->teardown < (uintptr_t)b->teardown) ? -1 : 1;
+    }
+    return (((const xanchor*)lhs)->order > ((const xanchor*)rhs)->order) - (((const xanchor*)lhs)->order < ((const xanchor*)rhs)->order);
+}
+
+static int xanchor_compare_position(const void* lhs, const void* rhs) {
+    const xanchor* a = (const xanchor*)lhs;
+    const xanchor* b = (const xanchor*)rhs;
+    if (a->anchor != b->anchor) {
+        return (a->anchor > b->anchor) - (a->anchor < b->anchor);
+    }
+    return (a->order > b->order) - (a->order < b->order);
+}
+
+// Moves the test cases sharing a fixture next to the first of them so each
+// group can be handed to one worker and set up once, others keep their place.
+static void xtest_group_fixtures(xregistry* registry) {
+    uint32_t count = registry->count;
+    uint32_t shared = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        shared += (registry->entries[i].flags & XTEST_FLAG_GROUPED) ? 1 : 0;
+    }
+    if (shared < 2) {
+        return;
+    }
+
+    xanchor* anchors = (xanchor*)malloc(count * sizeof(xanchor));
+    uint32_t* order = (uint32_t*)malloc(count * sizeof(uint32_t));
+    if (!anchors || !order) {
+        free(anchors);
+        free(order);
+        return; // the groups are then set up once per run of cases instead
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        anchors[i] = (xanchor){registry->tests[i]->fixture, i, i};
+    }
+
+    // sorting the shared cases by fixture puts every group in one run whose
+    // first entry holds the smallest position, which becomes the anchor
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (registry->entries[i].flags & XTEST_FLAG_GROUPED) {
+            xanchor swap = anchors[kept];
+            anchors[kept++] = anchors[i];
+            anchors[i] = swap;
+        }
+    }
+    qsort(anchors, shared, sizeof(xanchor), xanchor_compare_fixture);
+    for (uint32_t i = 1; i < shared; i++) {
+        if (xfixture_same(&anchors[i].fixture, &anchors[i - 1].fixture)) {
+            anchors[i].anchor = anchors[i - 1].anchor;
+        }
+    }
+
+    qsort(anchors, count, sizeof(xanchor), xanchor_compare_position);
+    for (uint32_t i = 0; i < count; i++) {
+        order[i] = anchors[i].order;
+    }
+    xregistry_reorder(registry, order, count);
+    free(order);
+    free(anchors);
+}
+
+// True when two test cases of the registry run inside the same shared or
+// snapshot fixture
+static xbool xtest_same_unit(xregistry* registry, uint32_t lhs, uint32_t rhs) {
+    uint32_t grouped = registry->entries[lhs].flags & XTEST_FLAG_GROUPED;
+    if ((registry->entries[lhs].flags | registry->entries[rhs].flags) & XTEST_FLAG_DEPENDS) {
+        return xfalse; // the graph hands its test cases out one at a time
+    }
+    return grouped && grouped == (registry->entries[rhs].flags & XTEST_FLAG_GROUPED)
+        && xfixture_same(&registry->tests[lhs]->fixture, &registry->tests[rhs]->fixture);
+}
+
+// End of the unit starting at a test case, test cases sharing a fixture are
+// next to each other in the registry and go to the same worker as one unit
+static uint32_t xtest_unit_end(xregistry* registry, uint32_t first) {
+    uint32_t end = first + 1;
+    while (end < registry->count && xtest_same_unit(registry, first, end)) {
+        end++;
+    }
+    return end;
+}
+
+// Moves the test cases at [first, count) of the registry carrying a flag to
+// the front of that range, keeping the order of both kinds and so the units.
+// Returns how many were moved.
+static uint32_t xtest_partition(xregistry* registry, uint32_t first, uint32_t flag) {
+    uint32_t flagged = 0;
+    for (uint32_t i = first; i < registry->count; i++) {
+        flagged += (registry->entries[i].flags & flag) ? 1 : 0;
+    }
+    if (flagged == 0 || flagged == registry->count - first) {
+        return flagged;
+    }
+
+    uint32_t* order = (uint32_t*)malloc(registry->count * sizeof(uint32_t));
+    if (!order) {
+        xconsole_out("red", "Error: unable to allocate the test table.\n");
+        exit(EXIT_FAILURE);
+    }
+    uint32_t front = first;
+    uint32_t back = first + flagged;
+    for (uint32_t i = 0; i < registry->count; i++) {
+        if (i < first) {
+            order[i] = i;
+        } else {
+            order[(registry->entries[i].flags & flag) ? front++ : back++] = i;
+        }
+    }
+    xregistry_reorder(registry, order, registry->count);
+    free(order);
+    return flagged;
+}
+
+// ==============================================================================
+// Xtest test dependencies
+// ==============================================================================
+
+// Declares that test_case runs only after prerequisite has passed
+void xtest_depends_on(xtest* test_case, xtest* prerequisite) {
+    if (!test_case || !prerequisite || test_case == prerequisite) {
+        xconsole_out("red", "Error: a test case cannot depend on itself.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (XDEPENDS.count == XDEPENDS.capacity) {
+        uint32_t capacity = XDEPENDS.capacity ? XDEPENDS.capacity * 2 : 16;
+        xdependency* edges = (xdependency*)realloc(XDEPENDS.edges, capacity * sizeof(xdependency));
+        if (!edges) {
+            xconsole_out("red", "Error: unable to allocate the test dependencies.\n");
+            exit(EXIT_FAILURE);
+        }
+        XDEPENDS.edges = edges;
+        XDEPENDS.capacity = capacity;
+    }
+    XDEPENDS.edges[XDEPENDS.count++] = (xdependency){test_case, prerequisite};
+} // end of func
+
+// Test case paired with its position in the registry
+typedef struct {
+    xtest* test;    // Test case, looked up by its address
+    uint32_t index; // Position of the test case in the registry
+} xposition;
+
+static int xposition_compare_test(const void* lhs, const void* rhs) {
+    uintptr_t a = (uintptr_t)((const xposition*)lhs)->test;
+    uintptr_t b = (uintptr_t)((const xposition*)rhs)->test;
+    return (a > b) - (a < b);
+}
+
+// Position of a test case among the sorted positions, XTEST_NONE when the
+// test case is not part of them
+static uint32_t xposition_find(const xposition* positions, uint32_t count, xtest* test) {
+    xposition key = {test, XTEST_NONE};
+    const xposition* found = (const xposition*)bsearch(&key, positions, count, sizeof(xposition), xposition_compare_test);
+    return found ? found->index : XTEST_NONE;
+}
+
+// Positions of the test cases at [first, end) of the registry sorted by address
+static xposition* xposition_table(xregistry* registry, uint32_t first, uint32_t end) {
+    xposition* positions = (xposition*)malloc((end > first ? end - first : 1) * sizeof(xposition));
+    if (!positions) {
+        xconsole_out("red", "Error: unable to allocate the dependency graph.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = first; i < end; i++) {
+        positions[i - first] = (xposition){registry->tests[i], i};
+    }
+    qsort(positions, end - first, sizeof(xposition), xposition_compare_test);
+    return positions;
+}
+
+static void xgraph_erase(void) {
+    free(XGRAPH.offsets);
+    free(XGRAPH.dependents);
+    free(XGRAPH.pending);
+    free(XGRAPH.blocker);
+    XGRAPH = (xgraph){xnullptr, xnullptr, xnullptr, xnullptr, 0, xfalse};
+}
+
+// Builds the graph of the dependencies between test cases at [first, end) of
+// the registry, false when none of them depends on another
+static xbool xgraph_build(xregistry* registry, uint32_t first, uint32_t end) {
+    uint32_t count = registry->count;
+    xposition* positions = xposition_table(registry, first, end);
+    uint32_t* from = (uint32_t*)malloc((XDEPENDS.count ? XDEPENDS.count : 1) * sizeof(uint32_t));
+    uint32_t* to = (uint32_t*)malloc((XDEPENDS.count ? XDEPENDS.count : 1) * sizeof(uint32_t));
+    if (!from || !to) {
+        xconsole_out("red", "Error: unable to allocate the dependency graph.\n");
+        exit(EXIT_FAILURE);
+    }
+    uint32_t edges = 0;
+    for (uint32_t e = 0; e < XDEPENDS.count; e++) {
+        from[edges] = xposition_find(positions, end - first, XDEPENDS.edges[e].prerequisite);
+        to[edges] = xposition_find(positions, end - first, XDEPENDS.edges[e].test);
+        edges += (from[edges] != XTEST_NONE && to[edges] != XTEST_NONE) ? 1 : 0;
+    }
+    free(positions);
+    if (edges == 0) {
+        free(from);
+        free(to);
+        return xfalse;
+    }
+
+    XGRAPH.offsets    = (uint32_t*)calloc(count + 1, sizeof(uint32_t));
+    XGRAPH.dependents = (uint32_t*)malloc(edges * sizeof(uint32_t));
+    XGRAPH.pending    = (uint32_t*)calloc(count, sizeof(uint32_t));
+    XGRAPH.blocker    = (uint32_t*)malloc(count * sizeof(uint32_t));
+    if (!XGRAPH.offsets || !XGRAPH.dependents || !XGRAPH.pending || !XGRAPH.blocker) {
+        xconsole_out("red", "Error: unable to allocate the dependency graph.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t e = 0; e < edges; e++) {
+        XGRAPH.offsets[from[e] + 1]++;
+        XGRAPH.pending[to[e]]++;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        XGRAPH.offsets[i + 1] += XGRAPH.offsets[i];
+        XGRAPH.blocker[i] = XTEST_NONE;
+        XGRAPH.waiting += (XGRAPH.pending[i] > 0) ? 1 : 0;
+    }
+    // dependents keep the order they were declared in
+    uint32_t* cursor = (uint32_t*)malloc(count * sizeof(uint32_t));
+    if (!cursor) {
+        xconsole_out("red", "Error: unable to allocate the dependency graph.\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(cursor, XGRAPH.offsets, count * sizeof(uint32_t));
+    for (uint32_t e = 0; e < edges; e++) {
+        XGRAPH.dependents[cursor[from[e]]++] = to[e];
+    }
+    free(cursor);
+    free(from);
+    free(to);
+    XGRAPH.active = xtrue;
+    return xtrue;
+}
+
+// Flags a test case taking part in a dependency. It runs as a plain test case
+// on a worker thread, a notice tells when that drops its async or snapshot way
+// of running, only once since the flags are gone after the first edge.
+static void xgraph_link(xregistry* registry, uint32_t index) {
+    uint32_t flags = registry->entries[index].flags;
+    if (flags & XTEST_FLAG_ASYNC) {
+        xconsole_out("orange", "Notice: %s has a dependency, it runs off the event loop and its waits block.\n", registry->tests[index]->name);
+    }
+    if (flags & XTEST_FLAG_SNAPSHOT) {
+        xconsole_out("orange", "Notice: %s has a dependency, its snapshot fixture is set up in process.\n", registry->tests[index]->name);
+    }
+    registry->entries[index].flags = (flags & ~(XTEST_FLAG_ASYNC | XTEST_FLAG_SNAPSHOT)) | XTEST_FLAG_DEPENDS;
+}
+
+// Flags the test cases of the registry taking part in a dependency, they are
+// scheduled as a graph on the worker threads so async ones block in
+// XTEST_AWAIT_* and snapshot fixtures are set up around each of them.
+// Dependency cycles are reported and stop the run.
+static void xgraph_resolve(xregistry* registry) {
+    if (XDEPENDS.count == 0) {
+        return;
+    }
+    xposition* positions = xposition_table(registry, 0, registry->count);
+    xbool linked = xfalse;
+    for (uint32_t e = 0; e < XDEPENDS.count; e++) {
+        uint32_t test = xposition_find(positions, registry->count, XDEPENDS.edges[e].test);
+        uint32_t prerequisite = xposition_find(positions, registry->count, XDEPENDS.edges[e].prerequisite);
+        if (test == XTEST_NONE) {
+            continue;
+        }
+        if (prerequisite == XTEST_NONE) {
+            xconsole_out("orange", "Notice: %s depends on %s which is not selected, running it anyway.\n",
+                         XDEPENDS.edges[e].test->name, XDEPENDS.edges[e].prerequisite->name);
+            continue;
+        }
+        xgraph_link(registry, test);
+        xgraph_link(registry, prerequisite);
+        linked = xtrue;
+    }
+    free(positions);
+    if (!linked) {
+        return;
+    }
+    if (xcli.isolate) {
+        xconsole_out("orange", "Notice: test cases with dependencies run in process, --isolate=fork does not cover them.\n");
+    }
+
+    // peel off test cases without unfinished prerequisites until none are
+    // left, whatever remains sits on a cycle
+    xgraph_build(registry, 0, registry->count);
+    uint32_t* ready = (uint32_t*)malloc(registry->count * sizeof(uint32_t));
+    if (!ready) {
+        xconsole_out("red", "Error: unable to allocate the dependency graph.\n");
+        exit(EXIT_FAILURE);
+    }
+    uint32_t head = 0;
+    uint32_t tail = 0;
+    for (uint32_t i = 0; i < registry->count; i++) {
+        if (XGRAPH.pending[i] == 0) {
+            ready[tail++] = i;
+        }
+    }
+    while (head < tail) {
+        uint32_t index = ready[head++];
+        for (uint32_t k = XGRAPH.offsets[index]; k < XGRAPH.offsets[index + 1]; k++) {
+            if (--XGRAPH.pending[XGRAPH.dependents[k]] == 0) {
+                ready[tail++] = XGRAPH.dependents[k];
+            }
+        }
+    }
+    for (uint32_t i = 0; i < registry->count; i++) {
+        if (XGRAPH.pending[i] > 0) {
+            xconsole_out("red", "Error: test dependencies form a cycle through %s.\n", registry->tests[i]->name);
+            exit(EXIT_FAILURE);
+        }
+    }
+    free(ready);
+    xgraph_erase();
+}
+
+// Group of every test case in the registry, given as the lowest position of
+// the test cases linked to it through XTEST_DEPENDS_ON, directly or not
+static uint32_t* xgraph_groups(xregistry* registry) {
+    uint32_t count = registry->count;
+    uint32_t* groups = (uint32_t*)malloc((count ? count : 1) * sizeof(uint32_t));
+    if (!groups) {
+        xconsole_out("red", "Error: unable to allocate the dependency graph.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        groups[i] = i;
+    }
+    if (XDEPENDS.count == 0) {
+        return groups;
+    }
+
+    xposition* positions = xposition_table(registry, 0, count);
+    for (uint32_t e = 0; e < XDEPENDS.count; e++) {
+        uint32_t lhs = xposition_find(positions, count, XDEPENDS.edges[e].test);
+        uint32_t rhs = xposition_find(positions, count, XDEPENDS.edges[e].prerequisite);
+        if (lhs == XTEST_NONE || rhs == XTEST_NONE) {
+            continue;
+        }
+        while (groups[lhs] != lhs) {
+            lhs = groups[lhs];
+        }
+        while (groups[rhs] != rhs) {
+            rhs = groups[rhs];
+        }
+        // the higher root joins the lower one, so a group points downwards
+        if (lhs < rhs) {
+            groups[rhs] = lhs;
+        } else {
+            groups[lhs] = rhs;
+        }
+    }
+    free(positions);
+
+    // a lower position is already resolved to its root when it is reached
+    for (uint32_t i = 0; i < count; i++) {
+        groups[i] = groups[groups[i]];
+    }
+    return groups;
+}
+
+// ==============================================================================
+// Xtest test name filters
+// ==============================================================================
+
+// Adds a pattern given to --filter or --exclude
+static void xfilter_add(xfilter* filter, xstring pattern) {
+    xstring* patterns = (xstring*)realloc(filter->patterns, (filter->count + 1) * sizeof(xstring));
+    if (!patterns) {
+        xconsole_out("red", "Error: unable to allocate the test filter.\n");
+        exit(EXIT_FAILURE);
+    }
+    patterns[filter->count++] = pattern;
+    filter->patterns = patterns;
+}
+
+// A pattern written as /regex/ is a regular expression, anything else a glob
+static xbool xfilter_is_regex(const char* pattern) {
+    size_t length = strlen(pattern);
+    return length >= 2 && pattern[0] == '/' && pattern[length - 1] == '/';
+}
+
+// Closing bracket of the glob class opening at glob, xnullptr when unterminated
+static const char* xfilter_class_end(const char* glob) {
+    const char* body = glob + 1;
+    body += (*body == '!') ? 1 : 0;
+    return (*body != '\0') ? strchr(body + 1, ']') : xnullptr;
+}
+
+#if !defined(_WIN32)
+// Translates a glob into an anchored extended regular expression, writing at
+// most 2 * strlen(glob) + 2 characters plus the terminator
+static char* xfilter_glob_to_regex(const char* glob, char* out) {
+    *out++ = '^';
+    for (; *glob; glob++) {
+        if (*glob == '*') {
+            *out++ = '.';
+            *out++ = '*';
+        } else if (*glob == '?') {
+            *out++ = '.';
+        } else if (*glob == '[' && xfilter_class_end(glob) != xnullptr) {
+            // a class is copied through, [!...] negates it like in a shell
+            const char* close = xfilter_class_end(glob);
+            *out++ = '[';
+            if (glob[1] == '!') {
+                *out++ = '^';
+                glob++;
+            }
+            while (++glob < close) {
+                *out++ = *glob;
+            }
+            *out++ = ']';
+        } else {
+            if (strchr(".^$+(){}|\\[]", *glob) != xnullptr) {
+                *out++ = '\\';
+            }
+            *out++ = *glob;
+        }
+    }
+    *out++ = '$';
+    *out = '\0';
+    return out;
+}
+#else
+// Matches a name against a glob, used where no regex library is available
+static xbool xfilter_glob_match(const char* glob, const char* name) {
+    const char* star = xnullptr;
+    const char* resume = xnullptr;
+
+    while (*name) {
+        if (*glob == '*') {
+            star = glob++;
+            resume = name;
+        } else if (*glob == '?') {
+            glob++;
+            name++;
+        } else if (*glob == '[' && xfilter_class_end(glob) != xnullptr) {
+            const char* close = xfilter_class_end(glob);
+            const char* cursor = glob + 1;
+            xbool negate = (*cursor == '!');
+            xbool found = xfalse;
+            cursor += negate ? 1 : 0;
+            do {
+                if (cursor + 2 < close && cursor[1] == '-') {
+                    found |= (*name >= cursor[0] && *name <= cursor[2]);
+                    cursor += 3;
+                } else {
+                    found |= (*name == *cursor);
+                    cursor++;
+                }
+            } while (cursor < close);
+            if (found == negate) {
+                goto backtrack;
+            }
+            glob = close + 1;
+            name++;
+        } else if (*glob == *name) {
+            glob++;
+            name++;
+        } else {
+            goto backtrack;
+        }
+        continue;
+
+    backtrack:
+        if (star == xnullptr) {
+            return xfalse;
+        }
+        glob = star + 1;
+        name = ++resume;
+    }
+    while (*glob == '*') {
+        glob++;
+    }
+    return *glob == '\0';
+}
+#endif
+
+// Compiles the patterns of a filter, a pattern that does not compile is an error
+static void xfilter_compile(xfilter* filter, const char* option) {
+    if (filter->count == 0) {
+        return;
+    }
+#if !defined(_WIN32)
+    size_t size = 1;
+    for (uint32_t i = 0; i < filter->count; i++) {
+        size += 2 * strlen(filter->patterns[i]) + 6;
+    }
+    char* expression = (char*)malloc(size);
+    if (!expression) {
+        xconsole_out("red", "Error: unable to allocate the test filter.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // (first)|(second)|... so one pass of the automaton checks every pattern
+    char* out = expression;
+    for (uint32_t i = 0; i < filter->count; i++) {
+        const char* pattern = filter->patterns[i];
+        if (i > 0) {
+            *out++ = '|';
+        }
+        *out++ = '(';
+        if (xfilter_is_regex(pattern)) {
+            size_t length = strlen(pattern) - 2;
+            memcpy(out, pattern + 1, length);
+            out += length;
+        } else {
+            out = xfilter_glob_to_regex(pattern, out);
+        }
+        *out++ = ')';
+    }
+    *out = '\0';
+
+    int status = regcomp(&filter->automaton, expression, REG_EXTENDED | REG_NOSUB);
+    if (status != 0) {
+        char reason[256];
+        regerror(status, &filter->automaton, reason, sizeof(reason));
+        xconsole_out("red", "Error: invalid %s pattern: %s\n", option, reason);
+        exit(EXIT_FAILURE);
+    }
+    filter->compiled = xtrue;
+    free(expression);
+#else
+    for (uint32_t i = 0; i < filter->count; i++) {
+        if (xfilter_is_regex(filter->patterns[i])) {
+            xconsole_out("orange", "Notice: %s regular expressions are not supported on this platform, matching %s as a glob.\n", option, filter->patterns[i]);
+        }
+    }
+#endif
+}
+
+// True when a test name matches any pattern of the filter
+static xbool xfilter_match(const xfilter* filter, const char* name) {
+#if !defined(_WIN32)
+    return filter->compiled && regexec(&filter->automaton, name, 0, xnullptr, 0) == 0;
+#else
+    for (uint32_t i = 0; i < filter->count; i++) {
+        const char* pattern = filter->patterns[i];
+        if (xfilter_is_regex(pattern)) {
+            char glob[512];
+            size_t length = strlen(pattern) - 2;
+            length = length < sizeof(glob) - 1 ? length : sizeof(glob) - 1;
+            memcpy(glob, pattern + 1, length);
+            glob[length] = '\0';
+            pattern = glob;
+            if (xfilter_glob_match(pattern, name)) {
+                return xtrue;
+            }
+        } else if (xfilter_glob_match(pattern, name)) {
+            return xtrue;
+        }
+    }
+    return xfalse;
+#endif
+}
+
+// Releases the patterns and the compiled automaton of a filter
+static void xfilter_erase(xfilter* filter) {
+#if !defined(_WIN32)
+    if (filter->compiled) {
+        regfree(&filter->automaton);
+        filter->compiled = xfalse;
+    }
+#endif
+    free(filter->patterns);
+    filter->patterns = xnullptr;
+    filter->count = 0;
+}
+
+// Drops the test cases left out by --only-*, --filter and --exclude from the
+// registry before anything is scheduled, so no fixture of theirs ever runs
+static void xtest_select(xregistry* registry) {
+    xbool by_class = xcli.only_test || xcli.only_mark || xcli.only_fish;
+    if (!by_class && XFILTER_INCLUDE.count == 0 && XFILTER_EXCLUDE.count == 0) {
+        return;
+    }
+
+    uint32_t* order = (uint32_t*)malloc(registry->count * sizeof(uint32_t));
+    if (!order) {
+        xconsole_out("red", "Error: unable to allocate the test filter.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < registry->count; i++) {
+        uint32_t kind = registry->entries[i].flags & (XTEST_FLAG_MARK | XTEST_FLAG_FISH);
+        if ((xcli.only_test && kind != 0) || (xcli.only_mark && kind != XTEST_FLAG_MARK) || (xcli.only_fish && kind != XTEST_FLAG_FISH)) {
+            continue;
+        }
+        const char* name = registry->tests[i]->name;
+        if (XFILTER_INCLUDE.count > 0 && !xfilter_match(&XFILTER_INCLUDE, name)) {
+            continue;
+        }
+        if (XFILTER_EXCLUDE.count > 0 && xfilter_match(&XFILTER_EXCLUDE, name)) {
+            continue;
+        }
+        order[kept++] = i;
+    }
+
+    XTEST_FILTERED = registry->count - kept;
+    xregistry_reorder(registry, order, kept);
+    free(order);
+}
+
+// ==============================================================================
+// Xtest basic utility functions
+// ==============================================================================
+
+// Updates the statistics
+static void xtest_update_scoreboard(xstats* stats, const xentry* entry) {
+    // Check if the test should be ignored
+    if (entry->flags & XTEST_FLAG_IGNORED) {
+        stats->ignored_count++;
+        return;
+    }
+    if (XTEST_CONTEXT.errors_case) {
+        stats->error_count++;
+        return;
+    }
+
+    // Update the appropriate count based on your logic
+    uint32_t kind = entry->flags & (XTEST_FLAG_MARK | XTEST_FLAG_FISH);
+    if (kind == 0) {
+        stats->test_count++;
+    } else if (kind == XTEST_FLAG_FISH) {
+        stats->fish_count++;
+    } else if (kind == XTEST_FLAG_MARK) {
+        stats->mark_count++;
+    }
+
+    // Update main score values
+    if (!XTEST_CONTEXT.pass_scan) {
+        stats->failed_count++;
+    } else {
+        stats->passed_count++;
+    }
+    stats->total_count++;
+} // end of func
+
+// Adds the scoreboard of a worker into the scoreboard of the engine
+static void xtest_merge_scoreboard(xstats* into, const xstats* from) {
+    into->passed_count  += from->passed_count;
+    into->failed_count  += from->failed_count;
+    into->ignored_count += from->ignored_count;
+    into->error_count   += from->error_count;
+    into->mark_count    += from->mark_count;
+    into->fish_count    += from->fish_count;
+    into->test_count    += from->test_count;
+    into->total_count   += from->total_count;
+    into->unrun_count   += from->unrun_count;
+} // end of func
+
+// Adds everything a worker has measured into the engine totals
+static void xtest_merge_worker(xengine* engine, xworker* worker) {
+    xtest_merge_scoreboard(&engine->stats, &worker->stats);
+    XFIXTURE_TIME   += worker->fixture_time;
+    XFIXTURE_SETUPS += worker->fixture_setups;
+} // end of func
+
+// Marks a test case as failed in this run and counts it towards --fail-fast
+static void xtest_report_failure(xentry* entry) {
+    entry->flags |= XTEST_FLAG_FAILED;
+    xatomic_add(&XTEST_FAILURES, 1);
+} // end of func
+
+// True once --fail-fast has been reached and no new test case may start
+static xbool xtest_cancelled(void) {
+    return xcli.fail_fast > 0 && xatomic_load(&XTEST_FAILURES) >= xcli.fail_fast;
+} // end of func
+
+// Timeout that applies to a test case, zero when it may run forever
+static uint32_t xtest_timeout(const xentry* entry) {
+    return entry->timeout ? entry->timeout : xcli.timeout;
+} // end of func
+
+// Arms the watchdog for the test case a supervised worker is about to run,
+// returns the shift of the thread running it
+static uint32_t xtest_watch(xworker* worker, uint32_t index) {
+#if !defined(_WIN32)
+    xregistry* registry = &worker->engine->registry;
+    uint32_t timeout = xtest_timeout(&registry->entries[index]);
+    if (!worker->supervised || timeout == 0) {
+        return worker->shift;
+    }
+    pthread_mutex_lock(&worker->lock);
+    uint32_t shift   = worker->shift;
+    worker->running  = index;
+    worker->deadline = registry->tests[index]->timer.start + (clock_t)((uint64_t)timeout * CLOCKS_PER_SEC / 1000);
+    pthread_mutex_unlock(&worker->lock);
+    return shift;
+#else
+    (void)worker;
+    (void)index;
+    return 0;
+#endif
+} // end of func
+
+// Disarms the watchdog, false when the watchdog has given up on the thread
+// during its shift, in which case the test case was recorded as an error and
+// the worker now belongs to a relief thread.
+static xbool xtest_unwatch(xworker* worker, uint32_t shift) {
+#if !defined(_WIN32)
+    if (!worker->supervised) {
+        return xtrue;
+    }
+    pthread_mutex_lock(&worker->lock);
+    xbool kept = worker->shift == shift;
+    if (kept) {
+        worker->running = XTEST_NONE;
+    }
+    pthread_mutex_unlock(&worker->lock);
+    return kept;
+#else
+    (void)worker;
+    (void)shift;
+    return xtrue;
+#endif
+} // end of func
+
+// Tears down the shared fixture a worker has set up, if any
+static void xtest_leave_fixture(xworker* worker) {
+    if (!worker->active.shared) {
+        return;
+    }
+    clock_t start = xtest_clock();
+    if (worker->active.teardown) {
+        worker->active.teardown();
+    }
+    worker->fixture_time += xtest_clock() - start;
+
+#if !defined(_WIN32)
+    pthread_mutex_lock(&worker->lock);
+#endif
+    worker->active = (xfixture){xnullptr, xnullptr, xfalse, xfalse};
+#if !defined(_WIN32)
+    pthread_mutex_unlock(&worker->lock);
+#endif
+} // end of func
+
+// Picks the fixture to run around a test case. A shared fixture stays set up
+// on the worker for as long as the following test cases use it too, so its
+// setup and teardown run once per group and only the body is run per case.
+static xfixture* xtest_enter_fixture(xworker* worker, uint32_t index) {
+    xtest* test_case = worker->engine->registry.tests[index];
+    if (!(worker->engine->registry.entries[index].flags & XTEST_FLAG_SHARED)) {
+        xtest_leave_fixture(worker);
+        return &test_case->fixture;
+    }
+    if (worker->active.shared && xfixture_same(&worker->active, &test_case->fixture)) {
+        return xnullptr;
+    }
+
+    xtest_leave_fixture(worker);
+#if !defined(_WIN32)
+    pthread_mutex_lock(&worker->lock);
+#endif
+    worker->active = test_case->fixture;
+#if !defined(_WIN32)
+    pthread_mutex_unlock(&worker->lock);
+#endif
+
+    clock_t start = xtest_clock();
+    if (worker->active.setup) {
+        worker->active.setup();
+    }
+    worker->fixture_time += xtest_clock() - start;
+    worker->fixture_setups++;
+    return xnullptr;
+} // end of func
+
+// Core steps to run a test case
+static void xtest_run(const xentry* entry, xtest* test_case, xfixture* fixture) {
+    XTEST_RUNNING = test_case;
+    XMARK_PROCESSED = (xmark_processed){0, 0};
+    XMARK_BUDGET.set = xfalse;
+    XMARK_OVERHEAD_WARNED = xfalse;
+    for (uint32_t iter = 0; iter < xcli.iter_repeat; iter++) {
+        if (fixture && fixture->setup) {
+            fixture->setup();
+        }
+
+        if (XSOAK.active) {
+            uint64_t start = xtest_nanos();
+            entry->test_function();
+            xatomic_add(&XSOAK.nanos, xtest_nanos() - start);
+            xatomic_add(&XSOAK.iterations, 1);
+        } else {
+            entry->test_function();
+        }
+
+        if (fixture && fixture->teardown) {
+            fixture->teardown();
+        }
+    }
+    XTEST_RUNNING = xnullptr;
+} // end of func
+
+// Scores a test case once its body has run, from the context it left behind
+static void xtest_conclude(xworker* worker, uint32_t index) {
+    xentry* entry = &worker->engine->registry.entries[index];
+    xtest* test_case = worker->engine->registry.tests[index];
+
+    if (XTEST_CONTEXT.ignore_case) {
+        entry->flags |= XTEST_FLAG_IGNORED;
+        test_case->config.ignored = xtrue;
+    }
+
+    entry->flags |= XTEST_FLAG_RAN;
+    xtest_update_scoreboard(&worker->stats, entry);
+    if (!(entry->flags & XTEST_FLAG_IGNORED) && (XTEST_CONTEXT.errors_case || !XTEST_CONTEXT.pass_scan)) {
+        xtest_report_failure(entry);
+    }
+    output_end_test(test_case);
+} // end of func
+
+// Hands each dependent of a finished test case whose last prerequisite it was
+// to the worker that ran it, a dependent of a test case that did not pass is
+// marked so it is skipped once its turn comes.
+static void xgraph_release(xworker* worker, uint32_t index, xbool passed) {
+    for (uint32_t k = XGRAPH.offsets[index]; k < XGRAPH.offsets[index + 1]; k++) {
+        uint32_t dependent = XGRAPH.dependents[k];
+        if (!passed) {
+            xatomic_store(&XGRAPH.blocker[dependent], index);
+        }
+        if (xatomic_sub(&XGRAPH.pending[dependent], 1) == 0) {
+#if !defined(_WIN32)
+            pthread_mutex_lock(&worker->lock);
+#endif
+            xdeque_push(&worker->deque, dependent);
+#if !defined(_WIN32)
+            pthread_mutex_unlock(&worker->lock);
+#endif
+            xatomic_sub(&XGRAPH.waiting, 1);
+        }
+    }
+} // end of func
+
+// Skips a test case whose prerequisite did not pass, it counts as ignored
+static void xtest_skip_blocked(xworker* worker, uint32_t index) {
+    xregistry* registry = &worker->engine->registry;
+    xtest* test_case = registry->tests[index];
+    test_case->config.ignored = xtrue;
+    test_case->timer.elapsed = 0;
+    output_blocked_format(test_case, registry->tests[xatomic_load(&XGRAPH.blocker[index])]);
+    worker->stats.ignored_count++;
+} // end of func
+
+// Common functionality for running a test case, false when the worker was
+// abandoned by the watchdog while the test case was running.
+static xbool xtest_run_test(xworker* worker, uint32_t index, xfixture* fixture) {
+    const xentry* entry = &worker->engine->registry.entries[index];
+    xtest* test_case = worker->engine->registry.tests[index];
+
+    // every test case starts from a clean context on the thread running it
+    XTEST_CONTEXT = (xcontext){xtrue, 0, xfalse, xfalse};
+    test_case->timer.start = xtest_clock();
+    output_start_test(test_case, worker);
+
+    if (xcli.dry_run) {
+        xconsole_out("blue", "Simulating test case...\n");
+        return xtrue;
+    }
+
+    uint32_t shift = xtest_watch(worker, index);
+    xtest_run(entry, test_case, fixture);
+    if (!xtest_unwatch(worker, shift)) {
+        return xfalse;
+    }
+    xtest_conclude(worker, index);
+    return xtrue;
+} // end of func
+
+// Takes a test case for a worker, the worker pops from the tail of its own
+// deque and when that runs dry steals from the head of another deque so a
+// long tail of slow test cases does not leave the other workers idle.
+static uint32_t xtest_take_test(xworker* worker) {
+    xregistry* registry = &worker->engine->registry;
+#if !defined(_WIN32)
+    pthread_mutex_lock(&worker->lock);
+#endif
+    uint32_t index = xdeque_pop_tail(&worker->deque);
+#if !defined(_WIN32)
+    pthread_mutex_unlock(&worker->lock);
+#endif
+
+    for (uint16_t k = 0; index == XTEST_NONE && k < worker->count; k++) {
+        xworker* victim = &worker->pool[(worker->id + k) % worker->count];
+        if (victim == worker) {
+            continue;
+        }
+        xdeque stolen = {xnullptr, 0, 0, 0};
+#if !defined(_WIN32)
+        pthread_mutex_lock(&victim->lock);
+#endif
+        // a group sharing the fixture the victim has set up stays with it,
+        // any other group is taken as a whole so it is set up only once more
+        uint32_t head = xdeque_peek_head(&victim->deque);
+        if (head != XTEST_NONE && !((registry->entries[head].flags & XTEST_FLAG_SHARED) && victim->active.shared && xfixture_same(&registry->tests[head]->fixture, &victim->active))) {
+            xdeque_push(&stolen, xdeque_pop_head(&victim->deque));
+            while (xdeque_peek_head(&victim->deque) != XTEST_NONE && xtest_same_unit(registry, xdeque_peek_head(&victim->deque), head)) {
+                xdeque_push(&stolen, xdeque_pop_head(&victim->deque));
+            }
+        }
+#if !defined(_WIN32)
+        pthread_mutex_unlock(&victim->lock);
+#endif
+        if (!xdeque_is_empty(&stolen)) {
+            // the unit keeps the head to tail order it had in the victim, so
+            // popping from the tail runs it in registry order
+#if !defined(_WIN32)
+            pthread_mutex_lock(&worker->lock);
+#endif
+            while (!xdeque_is_empty(&stolen)) {
+                xdeque_push(&worker->deque, xdeque_pop_head(&stolen));
+            }
+            index = xdeque_pop_tail(&worker->deque);
+#if !defined(_WIN32)
+            pthread_mutex_unlock(&worker->lock);
+#endif
+        }
+        free(stolen.slots);
+    }
+    return index;
+} // end of func
+
+// Takes the next test case for a worker. While test cases of a dependency
+// graph are still held back an idle worker waits for them to be released
+// instead of leaving, the count is read before looking so a release it
+// misses is one still to come.
+static uint32_t xtest_next_test(xworker* worker) {
+    struct timespec backoff = {0, 100000};
+    for (;;) {
+        if (xtest_cancelled()) {
+            return XTEST_NONE;
+        }
+        uint32_t waiting = XGRAPH.active ? xatomic_load(&XGRAPH.waiting) : 0;
+        uint32_t index = xtest_take_test(worker);
+        if (index != XTEST_NONE || waiting == 0) {
+            return index;
+        }
+#if defined(_WIN32)
+        Sleep(1);
+#else
+        nanosleep(&backoff, xnullptr);
+#endif
+    }
+} // end of func
+
+// Worker loop, keeps running test cases until the queue is drained
+static void* xtest_worker_main(void* arg) {
+    xworker* worker = (xworker*)arg;
+    uint32_t current_test;
+
+    while ((current_test = xtest_next_test(worker)) != XTEST_NONE) {
+        if (XGRAPH.active && xatomic_load(&XGRAPH.blocker[current_test]) != XTEST_NONE) {
+            xtest_skip_blocked(worker, current_test);
+            xgraph_release(worker, current_test, xfalse);
+            continue;
+        }
+        xfixture* fixture = xtest_enter_fixture(worker, current_test);
+        if (!xtest_run_test(worker, current_test, fixture)) {
+            return xnullptr; // the watchdog has moved on without this thread
+        }
+        if (XGRAPH.active) {
+            xbool ignored = (worker->engine->registry.entries[current_test].flags & XTEST_FLAG_IGNORED) != 0;
+            xgraph_release(worker, current_test, !ignored && !XTEST_CONTEXT.errors_case && XTEST_CONTEXT.pass_scan);
+        }
+    }
+    xtest_leave_fixture(worker);
+
+#if !defined(_WIN32)
+    if (worker->supervised) {
+        pthread_mutex_lock(&worker->lock);
+        worker->finished = xtrue;
+        pthread_mutex_unlock(&worker->lock);
+    }
+#endif
+    return xnullptr;
+} // end of func
+
+#if !defined(_WIN32)
+// Watchdog loop run by the calling thread while supervised workers drain the
+// deques. A thread stuck past the deadline of its test case is abandoned, the
+// test case is recorded as an error and a relief thread takes over the worker
+// where it stands: its deque, which the other workers keep stealing from, and
+// the shared fixture it has set up, which the relief tears down once the group
+// is over. Returns the number of abandoned threads, the workers they still
+// point at must stay alive.
+static uint32_t xtest_watchdog(xworker* workers, uint16_t started) {
+    uint32_t abandoned = 0;
+    struct timespec tick = {0, 1000000};
+
+    for (;;) {
+        xbool busy = xfalse;
+        clock_t now = xtest_clock();
+
+        for (uint16_t i = 0; i < started; i++) {
+            xworker* worker = &workers[i];
+            pthread_mutex_lock(&worker->lock);
+            if (worker->abandoned || worker->finished) {
+                pthread_mutex_unlock(&worker->lock);
+                continue;
+            }
+            busy = xtrue;
+            if (worker->running == XTEST_NONE || now < worker->deadline) {
+                pthread_mutex_unlock(&worker->lock);
+                continue;
+            }
+
+            uint32_t stuck = worker->running;
+            worker->running = XTEST_NONE;
+            worker->shift++;
+            worker->stats.error_count++;
+            pthread_mutex_unlock(&worker->lock);
+
+            output_timeout_format(worker->engine->registry.tests[stuck], xtest_timeout(&worker->engine->registry.entries[stuck]));
+            xtest_report_failure(&worker->engine->registry.entries[stuck]);
+            if (XGRAPH.active) {
+                xgraph_release(worker, stuck, xfalse); // the relief skips them
+            }
+            pthread_detach(worker->thread);
+            abandoned++;
+
+            if (pthread_create(&worker->thread, xnullptr, xtest_worker_main, worker) != 0) {
+                // nobody is left to hold the fixture, the other workers may
+                // steal its group and what stays in the deque is not run
+                pthread_mutex_lock(&worker->lock);
+                worker->abandoned = xtrue;
+                worker->active = (xfixture){xnullptr, xnullptr, xfalse, xfalse};
+                pthread_mutex_unlock(&worker->lock);
+            }
+        }
+
+        if (!busy) {
+            return abandoned;
+        }
+        nanosleep(&tick, xnullptr);
+    }
+} // end of func
+#endif
+
+#if defined(XTEST_ASYNC_LOOP)
+// Releases a coroutine, dropping whatever descriptor it still waits on
+static void xcoroutine_erase(xloop* loop, xcoroutine* co) {
+    if (co->fd >= 0) {
+        epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, co->fd, xnullptr);
+        close(co->fd);
+    }
+    munmap(co->stack, XTEST_ASYNC_STACK);
+    free(co);
+} // end of func
+
+// Entry point of every coroutine, returning resumes the loop through uc_link
+static void xcoroutine_main(void) {
+    xloop* loop = XTEST_LOOP;
+    xcoroutine* co = loop->current;
+    xregistry* registry = &loop->worker->engine->registry;
+
+    // a shared fixture is set up around each async case on its own
+    xtest_run(&registry->entries[co->index], registry->tests[co->index], &registry->tests[co->index]->fixture);
+    co->finished = xtrue;
+} // end of func
+
+// Points a coroutine at its own stack and entry point. getcontext returns
+// twice, so it stays out of xcoroutine_create where locals change around it.
+static void xcoroutine_prepare(xloop* loop, xcoroutine* co) {
+    getcontext(&co->context);
+    co->context.uc_stack.ss_sp   = co->stack;
+    co->context.uc_stack.ss_size = XTEST_ASYNC_STACK;
+    co->context.uc_link          = &loop->context;
+    makecontext(&co->context, xcoroutine_main, 0);
+} // end of func
+
+// Creates the coroutine of a test case, it first runs on the next loop pass
+static xcoroutine* xcoroutine_create(xloop* loop, uint32_t index) {
+    xregistry* registry = &loop->worker->engine->registry;
+    xcoroutine* co = (xcoroutine*)calloc(1, sizeof(xcoroutine));
+    if (!co) {
+        return xnullptr;
+    }
+    co->stack = mmap(xnullptr, XTEST_ASYNC_STACK, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (co->stack == MAP_FAILED) {
+        free(co);
+        return xnullptr;
+    }
+    mprotect(co->stack, (size_t)sysconf(_SC_PAGESIZE), PROT_NONE); // overflow faults
+
+    co->index    = index;
+    co->fd       = -1;
+    co->state    = (xcontext){xtrue, 0, xfalse, xfalse};
+    co->running  = registry->tests[index];
+    co->runnable = xtrue;
+    xcoroutine_prepare(loop, co);
+
+    xtest* test_case = registry->tests[index];
+    XTEST_CONTEXT = co->state;
+    test_case->timer.start = xtest_clock();
+    output_start_test(test_case, loop->worker);
+
+    uint32_t timeout = xtest_timeout(&registry->entries[index]);
+    if (timeout > 0) {
+        co->deadline = test_case->timer.start + (clock_t)((uint64_t)timeout * CLOCKS_PER_SEC / 1000);
+    }
+    return co;
+} // end of func
+
+// Runs a coroutine until it waits on something or its body returns
+static void xcoroutine_resume(xloop* loop, xcoroutine* co) {
+    co->runnable  = xfalse;
+    // the thread locals a test case reads belong to the coroutine resumed
+    XTEST_CONTEXT         = co->state;
+    XTEST_RUNNING         = co->running;
+    XMARK_TIMER           = co->timer;
+    XMARK_PROCESSED       = co->processed;
+    XMARK_BUDGET          = co->budget;
+    XMARK_OVERHEAD_WARNED = co->warned;
+    loop->current = co;
+    swapcontext(&loop->context, &co->context);
+    loop->current = xnullptr;
+    co->state     = XTEST_CONTEXT;
+    co->running   = XTEST_RUNNING;
+    co->timer     = XMARK_TIMER;
+    co->processed = XMARK_PROCESSED;
+    co->budget    = XMARK_BUDGET;
+    co->warned    = XMARK_OVERHEAD_WARNED;
+} // end of func
+
+// Milliseconds until a point in time, rounded up so the loop never wakes early
+static int xloop_remaining_ms(clock_t when, clock_t now) {
+    return (when > now) ? (int)((when - now) * 1000 / CLOCKS_PER_SEC) + 1 : 0;
+} // end of func
+
+// Runs the async test cases at [first, end) of the registry as coroutines on
+// the calling thread, switching to another one whenever a case waits on a
+// descriptor or a timer. Timeouts are enforced by the loop itself, a case
+// waiting past its deadline is dropped without its teardown while a case
+// spinning on the CPU cannot be taken away from it.
+static void xtest_run_async(xengine* engine, uint32_t first, uint32_t end) {
+    xworker worker = {0};
+    xloop loop;
+    uint32_t limit = (end - first < XTEST_ASYNC_LIMIT) ? end - first : XTEST_ASYNC_LIMIT;
+    xcoroutine** live = (xcoroutine**)calloc(limit, sizeof(xcoroutine*));
+    struct epoll_event events[64];
+
+    worker.engine  = engine;
+    worker.running = XTEST_NONE;
+    loop.epoll_fd  = epoll_create1(EPOLL_CLOEXEC);
+    loop.current   = xnullptr;
+    loop.worker    = &worker;
+    if (!live || loop.epoll_fd < 0) {
+        xconsole_out("red", "Error: unable to create the async event loop.\n");
+        exit(EXIT_FAILURE);
+    }
+    XTEST_LOOP = &loop;
+
+    uint32_t next = first;
+    uint32_t count = 0;
+    for (;;) {
+        while (count < limit && next < end && !xtest_cancelled()) {
+            live[count] = xcoroutine_create(&loop, next++);
+            if (!live[count++]) {
+                xconsole_out("red", "Error: unable to allocate an async test case.\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        // run everything that can run, finished cases make room for new ones
+        for (uint32_t i = 0; i < count; ) {
+            xcoroutine* co = live[i];
+            if (co->runnable) {
+                xcoroutine_resume(&loop, co);
+            }
+            if (co->finished) {
+                XTEST_CONTEXT = co->state;
+                xtest_conclude(&worker, co->index);
+                xcoroutine_erase(&loop, co);
+                live[i] = live[--count];
+                continue;
+            }
+            i++;
+        }
+        if (count == 0) {
+            if (next < end && !xtest_cancelled()) {
+                continue;
+            }
+            break;
+        }
+
+        // sleep until a descriptor is ready or the earliest timer is due
+        clock_t now = xtest_clock();
+        int wait_ms = -1;
+        for (uint32_t i = 0; i < count; i++) {
+            if (live[i]->wake) {
+                int remaining = xloop_remaining_ms(live[i]->wake, now);
+                wait_ms = (wait_ms < 0 || remaining < wait_ms) ? remaining : wait_ms;
+            }
+            if (live[i]->deadline) {
+                int remaining = xloop_remaining_ms(live[i]->deadline, now);
+                wait_ms = (wait_ms < 0 || remaining < wait_ms) ? remaining : wait_ms;
+            }
+        }
+        int ready = epoll_wait(loop.epoll_fd, events, 64, wait_ms);
+        for (int k = 0; k < ready; k++) {
+            xcoroutine* co = (xcoroutine*)events[k].data.ptr;
+            co->ready = ((events[k].events & EPOLLIN) ? XTEST_AWAIT_READ : 0)
+                      | ((events[k].events & EPOLLOUT) ? XTEST_AWAIT_WRITE : 0)
+                      | ((events[k].events & (EPOLLERR | EPOLLHUP)) ? XTEST_AWAIT_ERROR : 0);
+            co->runnable = xtrue;
+        }
+
+        now = xtest_clock();
+        for (uint32_t i = 0; i < count; ) {
+            xcoroutine* co = live[i];
+            if (co->wake && now >= co->wake) {
+                co->runnable = xtrue;
+            }
+            if (co->deadline && now >= co->deadline) {
+                output_timeout_format(engine->registry.tests[co->index], xtest_timeout(&engine->registry.entries[co->index]));
+                worker.stats.error_count++;
+                xtest_report_failure(&engine->registry.entries[co->index]);
+                xcoroutine_erase(&loop, co);
+                live[i] = live[--count];
+                continue;
+            }
+            i++;
+        }
+    }
+    worker.stats.unrun_count += end - next;
+    xtest_merge_worker(engine, &worker);
+
+    XTEST_LOOP = xnullptr;
+    close(loop.epoll_fd);
+    free(live);
+} // end of func
+#endif
+
+// Suspends an async test case until a descriptor is ready, anywhere else the
+// calling thread blocks in poll instead
+int xtest_await_fd(int fd, int events) {
+#if defined(XTEST_ASYNC_LOOP)
+    xloop* loop = XTEST_LOOP;
+    if (loop != xnullptr && loop->current != xnullptr) {
+        xcoroutine* co = loop->current;
+        struct epoll_event event;
+        event.events = EPOLLONESHOT
+                     | ((events & XTEST_AWAIT_READ) ? EPOLLIN : 0)
+                     | ((events & XTEST_AWAIT_WRITE) ? EPOLLOUT : 0);
+        event.data.ptr = co;
+
+        // a duplicate lets several coroutines wait on the same descriptor,
+        // descriptors epoll refuses such as regular files fall through to poll
+        co->fd = dup(fd);
+        if (co->fd >= 0 && epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, co->fd, &event) == 0) {
+            co->ready = 0;
+            swapcontext(&co->context, &loop->context);
+            epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, co->fd, xnullptr);
+            close(co->fd);
+            co->fd = -1;
+            return co->ready;
+        }
+        if (co->fd >= 0) {
+            close(co->fd);
+            co->fd = -1;
+        }
+    }
+#endif
+#if !defined(_WIN32)
+    struct pollfd watch = {fd, (short)(((events & XTEST_AWAIT_READ) ? POLLIN : 0) | ((events & XTEST_AWAIT_WRITE) ? POLLOUT : 0)), 0};
+    while (poll(&watch, 1, -1) < 0 && errno == EINTR) {
+        continue;
+    }
+    return ((watch.revents & POLLIN) ? XTEST_AWAIT_READ : 0)
+         | ((watch.revents & POLLOUT) ? XTEST_AWAIT_WRITE : 0)
+         | ((watch.revents & (POLLERR | POLLHUP | POLLNVAL)) ? XTEST_AWAIT_ERROR : 0);
+#else
+    (void)fd;
+    return events; // nothing to wait on here, the descriptor is taken as ready
+#endif
+} // end of func
+
+// Suspends an async test case for a number of milliseconds, anywhere else the
+// calling thread sleeps instead
+void xtest_await_ms(uint32_t ms) {
+#if defined(XTEST_ASYNC_LOOP)
+    xloop* loop = XTEST_LOOP;
+    if (loop != xnullptr && loop->current != xnullptr) {
+        xcoroutine* co = loop->current;
+        co->wake = xtest_clock() + (clock_t)((uint64_t)ms * CLOCKS_PER_SEC / 1000);
+        co->wake = co->wake ? co->wake : 1;
+        swapcontext(&co->context, &loop->context);
+        co->wake = 0;
+        return;
+    }
+#endif
+#if defined(_WIN32)
+    Sleep(ms);
+#else
+    struct timespec delay = {(time_t)(ms / 1000), (long)(ms % 1000) * 1000000L};
+    while (nanosleep(&delay, &delay) < 0 && errno == EINTR) {
+        continue;
+    }
+#endif
+} // end of func
+
+#if !defined(_WIN32)
+// Writes the whole buffer to a pipe, retrying on interrupts and short writes
+static xbool xpipe_write(int fd, const void* data, size_t size) {
+    const char* cursor = (const char*)data;
+    while (size > 0) {
+        ssize_t written = write(fd, cursor, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written <= 0) {
+            return xfalse;
+        }
+        cursor += written;
+        size -= (size_t)written;
+    }
+    return xtrue;
+} // end of func
+
+// Reads the whole buffer from a pipe, false on end of file or error
+static xbool xpipe_read(int fd, void* data, size_t size) {
+    char* cursor = (char*)data;
+    while (size > 0) {
+        ssize_t got = read(fd, cursor, size);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        } else if (got <= 0) {
+            return xfalse;
+        }
+        cursor += got;
+        size -= (size_t)got;
+    }
+    return xtrue;
+} // end of func
+
+// Loop of a pooled worker process, runs the units of test cases the parent
+// sends and streams a result record back per test case until the request
+// pipe is closed.
+static void xprocess_main(xengine* engine, int request_fd, int result_fd) {
+    xworker worker = {0};
+    xrequest request;
+
+    worker.engine  = engine;
+    worker.running = XTEST_NONE;
+    pthread_mutex_init(&worker.lock, xnullptr);
+    while (xpipe_read(request_fd, &request, sizeof(request))) {
+        for (uint32_t index = request.first; index < request.end; index++) {
+            worker.stats = (xstats){0, 0, 0, 0, 0, 0, 0, 0, 0};
+            worker.fixture_time = 0;
+            worker.fixture_setups = 0;
+
+            xtest_run_test(&worker, index, xtest_enter_fixture(&worker, index));
+            if (index + 1 == request.end) {
+                xtest_leave_fixture(&worker); // the unit is over
+            }
+            fflush(stdout);
+
+            xresult result = {
+                .index     = index,
+                .elapsed   = engine->registry.tests[index]->timer.elapsed,
+                .fixture   = worker.fixture_time,
+                .setups    = (uint16_t)worker.fixture_setups,
+                .stats     = worker.stats,
+                .status    = 0,
+                .timed_out = xfalse,
+            };
+            if (!xpipe_write(result_fd, &result, sizeof(result))) {
+                fflush(stdout);
+                _exit(EXIT_FAILURE);
+            }
+        }
+    }
+    fflush(stdout);
+    _exit(EXIT_SUCCESS);
+} // end of func
+
+// Forks one worker process of the pool, it only keeps its own pipe ends open
+static xbool xprocess_spawn(xprocess* pool, uint16_t slot, uint16_t count, xengine* engine) {
+    int request[2];
+    int result[2];
+
+    if (pipe(request) != 0) {
+        return xfalse;
+    }
+    if (pipe(result) != 0) {
+        close(request[0]);
+        close(request[1]);
+        return xfalse;
+    }
+
+    fflush(stdout); // nothing buffered by the parent may be printed twice
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(request[0]);
+        close(request[1]);
+        close(result[0]);
+        close(result[1]);
+        return xfalse;
+    } else if (pid == 0) {
+        for (uint16_t i = 0; i < count; i++) {
+            if (i != slot && pool[i].pid > 0) {
+                close(pool[i].request_fd);
+                close(pool[i].result_fd);
+            }
+        }
+        close(request[1]);
+        close(result[0]);
+        xprocess_main(engine, request[0], result[1]);
+    }
+
+    close(request[0]);
+    close(result[1]);
+    pool[slot].pid        = pid;
+    pool[slot].request_fd = request[1];
+    pool[slot].result_fd  = result[0];
+    pool[slot].current    = -1;
+    pool[slot].timed_out  = xfalse;
+    return xtrue;
+} // end of func
+
+// Closes the pipes of a worker process and reaps it, returns its wait status
+static int xprocess_reap(xprocess* worker) {
+    int status = 0;
+
+    close(worker->request_fd);
+    close(worker->result_fd);
+    while (waitpid(worker->pid, &status, 0) < 0 && errno == EINTR) {
+        continue;
+    }
+    worker->pid = 0;
+    return status;
+} // end of func
+
+// Hands a unit of test cases to a worker process
+static xbool xprocess_dispatch(xprocess* worker, uint32_t first, uint32_t end) {
+    xrequest request = {first, end};
+    if (!xpipe_write(worker->request_fd, &request, sizeof(request))) {
+        return xfalse;
+    }
+    worker->current = (int32_t)first;
+    worker->end     = end;
+    worker->started = xtest_clock();
+    return xtrue;
+} // end of func
+
+// Waits for a child of a snapshot template, killing children that run past
+// their deadline. Returns the pid of the child reaped.
+static pid_t xsnapshot_wait(pid_t* pids, clock_t* deadlines, xbool* timed_out, uint16_t jobs, int* status) {
+    xbool timed = xfalse;
+    for (uint16_t s = 0; s < jobs; s++) {
+        timed = timed || (pids[s] > 0 && deadlines[s] != 0);
+    }
+    if (!timed) {
+        pid_t pid;
+        while ((pid = waitpid(-1, status, 0)) < 0 && errno == EINTR) {
+            continue;
+        }
+        return pid;
+    }
+
+    struct timespec tick = {0, 1000000};
+    for (;;) {
+        pid_t pid = waitpid(-1, status, WNOHANG);
+        if (pid != 0 && !(pid < 0 && errno == EINTR)) {
+            return pid;
+        }
+        clock_t now = xtest_clock();
+        for (uint16_t s = 0; s < jobs; s++) {
+            if (pids[s] > 0 && deadlines[s] != 0 && now >= deadlines[s] && !timed_out[s]) {
+                timed_out[s] = xtrue;
+                kill(pids[s], SIGKILL);
+            }
+        }
+        nanosleep(&tick, xnullptr);
+    }
+} // end of func
+
+// Loop of the template process of a snapshot fixture. The fixture is set up
+// once, then every test case of the unit runs in a child forked from the
+// template, so it starts from a copy-on-write image of the set up state and
+// whatever it changes is thrown away with it. Results of the children are
+// relayed to the parent, a child that dies is reported by the template.
+static void xsnapshot_main(xengine* engine, uint32_t first, uint32_t end, uint16_t jobs, int parent_fd) {
+    xregistry* registry = &engine->registry;
+    xfixture* fixture = &registry->tests[first]->fixture;
+    pid_t* pids = (pid_t*)calloc(jobs, sizeof(pid_t));
+    uint32_t* running = (uint32_t*)calloc(jobs, sizeof(uint32_t));
+    clock_t* started = (clock_t*)calloc(jobs, sizeof(clock_t));
+    clock_t* deadlines = (clock_t*)calloc(jobs, sizeof(clock_t));
+    xbool* timed_out = (xbool*)calloc(jobs, sizeof(xbool));
+    uint8_t* reported = (uint8_t*)calloc(end - first, sizeof(uint8_t));
+    int results[2];
+    if (!pids || !running || !started || !deadlines || !timed_out || !reported || pipe(results) != 0) {
+        _exit(EXIT_FAILURE);
+    }
+
+    clock_t setup_time = xtest_clock();
+    if (fixture->setup) {
+        fixture->setup();
+    }
+    setup_time = xtest_clock() - setup_time;
+
+    uint32_t next = first;
+    uint16_t inflight = 0;
+    xbool setup_reported = xfalse;
+    for (;;) {
+        for (uint16_t s = 0; s < jobs && next < end && !xtest_cancelled(); s++) {
+            if (pids[s] > 0) {
+                continue;
+            }
+            fflush(stdout); // nothing buffered by the template may be printed twice
+            pid_t pid = fork();
+            if (pid == 0) {
+                xworker worker = {0};
+                worker.engine  = engine;
+                worker.running = XTEST_NONE;
+                close(results[0]);
+                close(parent_fd);
+                xtest_run_test(&worker, next, xnullptr);
+                fflush(stdout);
+
+                xresult result = {
+                    .index     = next,
+                    .elapsed   = registry->tests[next]->timer.elapsed,
+                    .fixture   = 0,
+                    .setups    = 0,
+                    .stats     = worker.stats,
+                    .status    = 0,
+                    .timed_out = xfalse,
+                };
+                _exit(xpipe_write(results[1], &result, sizeof(result)) ? EXIT_SUCCESS : EXIT_FAILURE);
+            } else if (pid < 0) {
+                if (inflight == 0) {
+                    _exit(EXIT_FAILURE);
+                }
+                break; // retried once a child has been reaped
+            }
+            uint32_t timeout = xtest_timeout(&registry->entries[next]);
+            pids[s]      = pid;
+            running[s]   = next++;
+            started[s]   = xtest_clock();
+            deadlines[s] = timeout ? started[s] + (clock_t)((uint64_t)timeout * CLOCKS_PER_SEC / 1000) : 0;
+            timed_out[s] = xfalse;
+            inflight++;
+        }
+        if (inflight == 0) {
+            break;
+        }
+
+        int status = 0;
+        pid_t pid = xsnapshot_wait(pids, deadlines, timed_out, jobs, &status);
+        uint16_t slot = 0;
+        while (slot < jobs && pids[slot] != pid) {
+            slot++;
+        }
+        if (slot == jobs) {
+            continue;
+        }
+
+        // a child writes its result before it exits, so once it has been
+        // reaped its result is either in the pipe or will never come
+        struct pollfd pending = {results[0], POLLIN, 0};
+        xresult result;
+        while (poll(&pending, 1, 0) > 0 && (pending.revents & POLLIN) && xpipe_read(results[0], &result, sizeof(result))) {
+            reported[result.index - first] = 1;
+            if (!setup_reported) {
+                result.fixture = setup_time;
+                result.setups = 1;
+                setup_reported = xtrue;
+            }
+            if (result.stats.failed_count > 0 || result.stats.error_count > 0) {
+                xtest_report_failure(&engine->registry.entries[result.index]);
+            }
+            xpipe_write(parent_fd, &result, sizeof(result));
+        }
+        if (!reported[running[slot] - first]) {
+            xstats stats = {0, 0, 0, 1, 0, 0, 0, 0, 0};
+            xresult lost = {
+                .index     = running[slot],
+                .elapsed   = xtest_clock() - started[slot],
+                .fixture   = 0,
+                .setups    = 0,
+                .stats     = stats,
+                .status    = status ? status : -1,
+                .timed_out = timed_out[slot],
+            };
+            if (!setup_reported) {
+                lost.fixture = setup_time;
+                lost.setups = 1;
+                setup_reported = xtrue;
+            }
+            reported[running[slot] - first] = 1;
+            xtest_report_failure(&engine->registry.entries[running[slot]]);
+            xpipe_write(parent_fd, &lost, sizeof(lost));
+        }
+        pids[slot] = 0;
+        inflight--;
+    }
+
+    if (fixture->teardown) {
+        fixture->teardown();
+    }
+    fflush(stdout);
+    _exit(EXIT_SUCCESS);
+} // end of func
+
+// Runs the units of snapshot fixture test cases at [first, end) of the
+// registry, one template process per unit with up to jobs children at a time.
+static void xtest_run_snapshots(xengine* engine, uint32_t first, uint32_t end, uint16_t jobs) {
+    xregistry* registry = &engine->registry;
+    void (*previous_handler)(int) = signal(SIGPIPE, SIG_IGN);
+
+    for (uint32_t unit = first; unit < end; ) {
+        uint32_t unit_end = xtest_unit_end(registry, unit);
+        if (xtest_cancelled()) {
+            engine->stats.unrun_count += end - unit;
+            break;
+        }
+
+        int channel[2];
+        if (pipe(channel) != 0) {
+            xconsole_out("red", "Error: unable to create the snapshot pipe.\n");
+            exit(EXIT_FAILURE);
+        }
+        fflush(stdout);
+        pid_t template_pid = fork();
+        if (template_pid < 0) {
+            xconsole_out("red", "Error: unable to fork the snapshot template.\n");
+            exit(EXIT_FAILURE);
+        } else if (template_pid == 0) {
+            close(channel[0]);
+            xsnapshot_main(engine, unit, unit_end, jobs, channel[1]);
+        }
+        close(channel[1]);
+
+        uint32_t done = 0;
+        uint8_t* seen = (uint8_t*)calloc(unit_end - unit, sizeof(uint8_t));
+        if (!seen) {
+            xconsole_out("red", "Error: unable to allocate the snapshot results.\n");
+            exit(EXIT_FAILURE);
+        }
+        xresult result;
+        while (xpipe_read(channel[0], &result, sizeof(result))) {
+            seen[result.index - unit] = 1;
+            xtest* test_case = registry->tests[result.index];
+            test_case->timer.elapsed = result.elapsed;
+            test_case->config.ignored = result.stats.ignored_count > 0;
+            if (test_case->config.ignored) {
+                registry->entries[result.index].flags |= XTEST_FLAG_IGNORED;
+            }
+            if (result.timed_out) {
+                output_timeout_format(test_case, xtest_timeout(&registry->entries[result.index]));
+            } else if (result.status != 0) {
+                output_crash_format(test_case, result.status);
+            } else {
+                registry->entries[result.index].flags |= XTEST_FLAG_RAN;
+            }
+            xtest_merge_scoreboard(&engine->stats, &result.stats);
+            XFIXTURE_TIME   += result.fixture;
+            XFIXTURE_SETUPS += result.setups;
+            if (result.stats.failed_count > 0 || result.stats.error_count > 0) {
+                xtest_report_failure(&registry->entries[result.index]);
+            }
+            done++;
+        }
+        close(channel[0]);
+
+        int status = 0;
+        while (waitpid(template_pid, &status, 0) < 0 && errno == EINTR) {
+            continue;
+        }
+        if (done < unit_end - unit) {
+            if (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS) {
+                engine->stats.unrun_count += unit_end - unit - done; // fail-fast
+            } else {
+                // the template died, most likely in the fixture setup
+                output_crash_format(registry->tests[unit], status);
+                engine->stats.error_count += unit_end - unit - done;
+                xtest_report_failure(&registry->entries[unit]);
+                for (uint32_t k = unit; k < unit_end; k++) {
+                    registry->entries[k].flags |= seen[k - unit] ? 0 : XTEST_FLAG_FAILED;
+                }
+            }
+        }
+        free(seen);
+        unit = unit_end;
+    }
+    signal(SIGPIPE, previous_handler);
+} // end of func
+
+// Runs the queue on a pool of pre-forked worker processes, a test case that
+// crashes only takes its worker down and is recorded as an error.
+static void xtest_run_isolated(xengine* engine, uint32_t first, uint16_t jobs) {
+    xregistry* registry = &engine->registry;
+    uint32_t count = registry->count;
+    xprocess* pool = (xprocess*)calloc(jobs, sizeof(xprocess));
+    struct pollfd* fds = (struct pollfd*)calloc(jobs, sizeof(struct pollfd));
+    if (!pool || !fds) {
+        xconsole_out("red", "Error: unable to allocate the worker pool.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // a worker that dies between two test cases must not kill the parent
+    void (*previous_handler)(int) = signal(SIGPIPE, SIG_IGN);
+
+    uint32_t next = first;
+    uint32_t done = 0;
+    uint32_t limit = count; // lowered to stop handing out work on fail-fast
+    for (uint16_t i = 0; i < jobs; i++) {
+        if (!xprocess_spawn(pool, i, jobs, engine)) {
+            xconsole_out("red", "Error: unable to fork worker process %u.\n", i);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    for (;;) {
+        // hand out work to idle workers, closing the request pipe of a worker
+        // tells it there is nothing left to do
+        uint16_t watched = 0;
+        for (uint16_t i = 0; i < jobs; i++) {
+            if (pool[i].pid <= 0) {
+                continue;
+            }
+            if (pool[i].current < 0 && next < limit) {
+                uint32_t end = xtest_unit_end(registry, next);
+                if (xprocess_dispatch(&pool[i], next, end)) {
+                    next = end;
+                }
+            }
+            if (pool[i].current >= 0) {
+                fds[watched].fd = pool[i].result_fd;
+                fds[watched].events = POLLIN;
+                fds[watched].revents = 0;
+                watched++;
+            }
+        }
+
+        if (watched == 0) {
+            break; // nothing in flight and nothing left to hand out
+        }
+
+        // the poll wakes up in time for the earliest deadline in flight
+        int wait_ms = -1;
+        clock_t now = xtest_clock();
+        for (uint16_t i = 0; i < jobs; i++) {
+            uint32_t timeout = (pool[i].pid > 0 && pool[i].current >= 0) ? xtest_timeout(&registry->entries[pool[i].current]) : 0;
+            if (timeout > 0) {
+                clock_t deadline = pool[i].started + (clock_t)((uint64_t)timeout * CLOCKS_PER_SEC / 1000);
+                int remaining = (deadline > now) ? (int)((deadline - now) * 1000 / CLOCKS_PER_SEC) + 1 : 0;
+                wait_ms = (wait_ms < 0 || remaining < wait_ms) ? remaining : wait_ms;
+            }
+        }
+        if (poll(fds, watched, wait_ms) < 0 && errno != EINTR) {
+            break;
+        }
+
+        // a worker past its deadline is killed, its pipe then reports the loss
+        now = xtest_clock();
+        for (uint16_t i = 0; i < jobs; i++) {
+            uint32_t timeout = (pool[i].pid > 0 && pool[i].current >= 0) ? xtest_timeout(&registry->entries[pool[i].current]) : 0;
+            if (timeout > 0 && !pool[i].timed_out && now - pool[i].started >= (clock_t)((uint64_t)timeout * CLOCKS_PER_SEC / 1000)) {
+                pool[i].timed_out = xtrue;
+                kill(pool[i].pid, SIGKILL);
+            }
+        }
+
+        for (uint16_t i = 0; i < jobs; i++) {
+            if (pool[i].pid <= 0 || pool[i].current < 0) {
+                continue;
+            }
+            uint16_t k = 0;
+            while (k < watched && fds[k].fd != pool[i].result_fd) {
+                k++;
+            }
+            if (k == watched || fds[k].revents == 0) {
+                continue;
+            }
+
+            xresult result;
+            if (xpipe_read(pool[i].result_fd, &result, sizeof(result))) {
+                xtest* test_case = registry->tests[result.index];
+                test_case->timer.elapsed = result.elapsed;
+                registry->entries[result.index].flags |= XTEST_FLAG_RAN;
+                test_case->config.ignored = result.stats.ignored_count > 0;
+                if (test_case->config.ignored) {
+                    registry->entries[result.index].flags |= XTEST_FLAG_IGNORED;
+                }
+                xtest_merge_scoreboard(&engine->stats, &result.stats);
+                XFIXTURE_TIME   += result.fixture;
+                XFIXTURE_SETUPS += result.setups;
+                if (result.stats.failed_count > 0 || result.stats.error_count > 0) {
+                    xtest_report_failure(&registry->entries[result.index]);
+                }
+                if (result.index + 1 < pool[i].end) {
+                    pool[i].current = (int32_t)result.index + 1;
+                    pool[i].started = xtest_clock();
+                } else {
+                    pool[i].current = -1;
+                }
+            } else {
+                // the worker went away with a test case in flight
+                xtest* test_case = registry->tests[pool[i].current];
+                test_case->timer.elapsed = xtest_clock() - pool[i].started;
+                xbool timed_out = pool[i].timed_out;
+                int status = xprocess_reap(&pool[i]);
+                if (timed_out) {
+                    output_timeout_format(test_case, xtest_timeout(&registry->entries[pool[i].current]));
+                } else {
+                    output_crash_format(test_case, status);
+                }
+                engine->stats.error_count++;
+                xtest_report_failure(&registry->entries[pool[i].current]);
+
+                // the rest of the unit goes to the replacement worker
+                uint32_t rest = (uint32_t)pool[i].current + 1;
+                uint32_t end  = pool[i].end;
+                pool[i].current = -1;
+                if ((next < count || rest < end) && !xtest_cancelled()) {
+                    if (!xprocess_spawn(pool, i, jobs, engine)) {
+                        xconsole_out("red", "Error: unable to fork worker process %u.\n", i);
+                        exit(EXIT_FAILURE);
+                    }
+                    if (rest < end) {
+                        xprocess_dispatch(&pool[i], rest, end);
+                    }
+                }
+            }
+            done++;
+        }
+
+        if (xtest_cancelled()) {
+            limit = next; // in flight cases finish, nothing new is handed out
+        }
+    }
+    engine->stats.unrun_count += count - first - done;
+
+    for (uint16_t i = 0; i < jobs; i++) {
+        if (pool[i].pid > 0) {
+            xprocess_reap(&pool[i]);
+        }
+    }
+    signal(SIGPIPE, previous_handler);
+
+    free(fds);
+    free(pool);
+} // end of func
+#endif
+
+// ==============================================================================
+// Xtest soak runs
+// ==============================================================================
+
+// Takes one sample of the resource usage of the process
+static void xsoak_sample(xsample* sample, uint64_t since, uint64_t* iterations, uint64_t* nanos) {
+    sample->elapsed = (double)(xtest_nanos() - since) / 1e9;
+    sample->rss = -1.0;
+    sample->fds = -1.0;
+    sample->threads = -1.0;
+
+#if defined(__linux__)
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm) {
+        unsigned long long size = 0;
+        unsigned long long resident = 0;
+        if (fscanf(statm, "%llu %llu", &size, &resident) == 2) {
+            sample->rss = (double)resident * (double)sysconf(_SC_PAGESIZE);
+        }
+        fclose(statm);
+    }
+
+    FILE* status = fopen("/proc/self/status", "r");
+    if (status) {
+        char line[128];
+        while (fgets(line, sizeof(line), status)) {
+            unsigned long threads = 0;
+            if (sscanf(line, "Threads: %lu", &threads) == 1) {
+                sample->threads = (double)threads;
+                break;
+            }
+        }
+        fclose(status);
+    }
+
+    DIR* fds = opendir("/proc/self/fd");
+    if (fds) {
+        double count = -1.0; // the directory itself is open while it is read
+        for (struct dirent* entry = readdir(fds); entry != xnullptr; entry = readdir(fds)) {
+            count += (entry->d_name[0] != '.') ? 1.0 : 0.0;
+        }
+        closedir(fds);
+        sample->fds = count;
+    }
+#elif !defined(_WIN32)
+    long limit = sysconf(_SC_OPEN_MAX);
+    limit = (limit > 0 && limit < 65536) ? limit : 65536;
+    sample->fds = 0.0;
+    for (long fd = 0; fd < limit; fd++) {
+        sample->fds += (fcntl((int)fd, F_GETFD) != -1) ? 1.0 : 0.0;
+    }
+#endif
+
+    // mean time of the body runs finished since the previous sample
+    uint64_t total_iterations = xatomic_load(&XSOAK.iterations);
+    uint64_t total_nanos = xatomic_load(&XSOAK.nanos);
+    if (total_iterations > *iterations) {
+        sample->iteration = (double)(total_nanos - *nanos) / (double)(total_iterations - *iterations);
+    } else {
+        sample->iteration = -1.0;
+    }
+    *iterations = total_iterations;
+    *nanos = total_nanos;
+}
+
+// Records a sample, the samples grow as long as the soak run goes on
+static void xsoak_record(const xsample* sample) {
+    if (XSOAK.count == XSOAK.capacity) {
+        size_t capacity = XSOAK.capacity ? XSOAK.capacity * 2 : 256;
+        xsample* samples = (xsample*)realloc(XSOAK.samples, capacity * sizeof(xsample));
+        if (!samples) {
+            return; // the trend is then drawn from the samples so far
+        }
+        XSOAK.samples = samples;
+        XSOAK.capacity = capacity;
+    }
+    XSOAK.samples[XSOAK.count++] = *sample;
+}
+
+// Interval between two samples, a long soak run is sampled about 200 times
+static uint64_t xsoak_interval(void) {
+    double seconds = (xcli.repeat_for > 0.0) ? xcli.repeat_for / 200.0 : 1.0;
+    seconds = (seconds < 0.1) ? 0.1 : (seconds > 10.0) ? 10.0 : seconds;
+    return (uint64_t)(seconds * 1e9);
+}
+
+#if !defined(_WIN32)
+// Sampler thread, samples the process until it is told to stop
+static void* xsoak_main(void* arg) {
+    uint64_t since = *(uint64_t*)arg;
+    uint64_t iterations = 0;
+    uint64_t nanos = 0;
+    uint64_t interval = xsoak_interval();
+    uint64_t next = since + interval;
+    struct timespec tick = {0, 10000000};
+    xsample sample;
+
+    free(arg);
+    xsoak_sample(&sample, since, &iterations, &nanos);
+    xsoak_record(&sample);
+    while (!xatomic_load(&XSOAK.stop)) {
+        if (xtest_nanos() >= next) {
+            xsoak_sample(&sample, since, &iterations, &nanos);
+            xsoak_record(&sample);
+            next += interval;
+        }
+        nanosleep(&tick, xnullptr);
+    }
+    return xnullptr;
+}
+#endif
+
+// Starts timing the body runs and sampling the process
+static void xsoak_start(void) {
+    XSOAK.active = xtrue;
+#if !defined(_WIN32)
+    if (xcli.isolate) {
+        xconsole_out("orange", "Notice: --isolate=fork runs the tests in other processes, soak samples only cover the runner.\n");
+    }
+    uint64_t* since = (uint64_t*)malloc(sizeof(uint64_t));
+    if (since) {
+        *since = xtest_nanos();
+        if (pthread_create(&XSOAK.thread, xnullptr, xsoak_main, since) == 0) {
+            return;
+        }
+        free(since);
+    }
+    xconsole_out("orange", "Notice: unable to start the soak sampler, no trend report will be made.\n");
+    XSOAK.stop = 1;
+#else
+    xconsole_out("orange", "Notice: soak sampling is not supported on this platform, no trend report will be made.\n");
+    XSOAK.stop = 1;
+#endif
+}
+
+// Stops the sampler thread
+static void xsoak_stop(void) {
+    XSOAK.active = xfalse;
+#if !defined(_WIN32)
+    if (!XSOAK.stop) {
+        xatomic_add(&XSOAK.stop, 1);
+        pthread_join(XSOAK.thread, xnullptr);
+    }
+#endif
+}
+
+// Least squares fit of one metric of the samples against time, after the
+// first tenth which is left out as warm up. False when the metric has fewer
+// than four usable samples.
+static xbool xsoak_fit(size_t offset, double* start, double* end) {
+    double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+    double first = 0.0, last = 0.0;
+    size_t used = 0;
+
+    for (size_t i = XSOAK.count / 10; i < XSOAK.count; i++) {
+        double x = XSOAK.samples[i].elapsed;
+        double y = *(const double*)((const char*)&XSOAK.samples[i] + offset);
+        if (y < 0.0) {
+            continue;
+        }
+        first = used ? first : x;
+        last = x;
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+        used++;
+    }
+    if (used < 4 || last <= first) {
+        return xfalse;
+    }
+
+    double n = (double)used;
+    double slope = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+    double intercept = (sy - slope * sx) / n;
+    *start = intercept + slope * first;
+    *end = intercept + slope * last;
+    return xtrue;
+}
+
+// Prints the fitted start and end of a metric and flags a steady rise of
+// more than ten percent that is also above the noise floor of the metric
+static void xsoak_trend(const char* label, size_t offset, double floor, double scale, const char* unit, const char* verdict) {
+    double start = 0.0;
+    double end = 0.0;
+    if (!xsoak_fit(offset, &start, &end)) {
+        xconsole_out("cyan", "> - %-12s: - not sampled\n", label);
+        return;
+    }
+
+    double change = (start > 0.0) ? (end - start) * 100.0 / start : 0.0;
+    xbool growing = (end - start) > floor && (start <= 0.0 || change > 10.0);
+    xconsole_out(growing ? "red" : "cyan", "> - %-12s: - %.2f%s -> %.2f%s (%+.1f%%) %s\n",
+                 label, start / scale, unit, end / scale, unit, change, growing ? verdict : "steady");
+}
+
+// Prints the resource trends of the soak run
+static void xsoak_report(void) {
+    if (XSOAK.count < 4) {
+        free(XSOAK.samples);
+        XSOAK.samples = xnullptr;
+        return; // too short a run to tell a trend
+    }
+
+    double elapsed = XSOAK.samples[XSOAK.count - 1].elapsed;
+    xconsole_out("blue", "[Soak Trend: Fossil Test]: %u rounds, %llu runs, %zu samples over %.1f seconds\n",
+                 XSOAK.rounds, (unsigned long long)xatomic_load(&XSOAK.iterations), XSOAK.count, elapsed);
+    xsoak_trend("Memory RSS", offsetof(xsample, rss), 1024.0 * 1024.0, 1024.0 * 1024.0, " MiB", "growing, possible leak");
+    xsoak_trend("Open fds", offsetof(xsample, fds), 1.0, 1.0, "", "growing, possible descriptor leak");
+    xsoak_trend("Threads", offsetof(xsample, threads), 1.0, 1.0, "", "growing, possible thread leak");
+    xsoak_trend("Iteration", offsetof(xsample, iteration), 0.0, 1000.0, " us", "slowing down");
+    xconsole_out("blue", "***************************:\n");
+
+    free(XSOAK.samples);
+    XSOAK.samples = xnullptr;
+}
 
 // ==============================================================================
-// Xtest internal argument parser logic
+// Xtest benchmark baselines
 // ==============================================================================
 
-// Function to check if a specific option is present
-static xbool xparser_has_option(int argc, xstring argv[], const xstring option) {
-    for (int32_t i = 1; i < argc; i++) {
-        if (strcmp(argv[i], option) == 0) {
-            return xtrue;
+static xbaseline_entry* xbaseline_find(xbaseline* baseline, const char* name) {
+    for (size_t i = 0; i < baseline->count; i++) {
+        if (strcmp(baseline->entries[i].name, name) == 0) {
+            return &baseline->entries[i];
         }
     }
-    return xfalse;
+    return xnullptr;
+}
+
+// Stores the samples of a benchmark, replacing the ones it had before. The
+// table takes ownership of the samples.
+static void xbaseline_store(xbaseline* baseline, const char* name, double* samples, uint32_t count, xmark_processed processed) {
+    xbaseline_entry* entry = xbaseline_find(baseline, name);
+    if (entry) {
+        free(entry->samples);
+        entry->samples = samples;
+        entry->count = count;
+        entry->processed = processed;
+        return;
+    }
+    if (baseline->count == baseline->capacity) {
+        size_t capacity = baseline->capacity ? baseline->capacity * 2 : 16;
+        xbaseline_entry* entries = (xbaseline_entry*)realloc(baseline->entries, capacity * sizeof(xbaseline_entry));
+        if (!entries) {
+            xconsole_out("red", "Error: unable to allocate the benchmark baseline.\n");
+            exit(EXIT_FAILURE);
+        }
+        baseline->entries = entries;
+        baseline->capacity = capacity;
+    }
+    baseline->entries[baseline->count++] = (xbaseline_entry){xstrdup((const xstring)name), samples, count, processed};
+}
+
+static void xbaseline_erase(xbaseline* baseline) {
+    for (size_t i = 0; i < baseline->count; i++) {
+        free(baseline->entries[i].name);
+        free(baseline->entries[i].samples);
+    }
+    free(baseline->entries);
+    *baseline = (xbaseline){xnullptr, 0, 0};
+}
+
+// Keeps the sorted samples of a finished benchmark loop, called from any
+// worker thread so the table is guarded
+static void xbaseline_record(const char* name, const double* sorted, uint32_t count, const xmark_processed* processed) {
+    double* samples = (double*)malloc(count * sizeof(double));
+    if (!samples) {
+        xconsole_out("red", "Error: unable to allocate the benchmark baseline.\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(samples, sorted, count * sizeof(double));
+#if !defined(_WIN32)
+    pthread_mutex_lock(&XBASELINE_LOCK);
+#endif
+    xbaseline_store(&XBASELINE, name, samples, count, *processed);
+#if !defined(_WIN32)
+    pthread_mutex_unlock(&XBASELINE_LOCK);
+#endif
+}
+
+// Loads the benchmarks of a baseline file, returns xfalse when it cannot be read
+static xbool xbaseline_load(xbaseline* baseline, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return xfalse;
+    }
+
+    char name[512];
+    unsigned count;
+    unsigned long long bytes;
+    unsigned long long items;
+    while (fscanf(file, "%511s", name) == 1) {
+        if (name[0] == '#') {
+            int c;
+            while ((c = fgetc(file)) != EOF && c != '\n') {
+                // comment runs to the end of the line
+            }
+            continue;
+        }
+        if (fscanf(file, "%u %llu %llu", &count, &bytes, &items) != 3 || count < MIN_MARK_SAMPLES || count > MAX_MARK_SAMPLES) {
+            break;
+        }
+        double* samples = (double*)malloc(count * sizeof(double));
+        if (!samples) {
+            xconsole_out("red", "Error: unable to allocate the benchmark baseline.\n");
+            exit(EXIT_FAILURE);
+        }
+        unsigned read = 0;
+        while (read < count && fscanf(file, "%lf", &samples[read]) == 1) {
+            read++;
+        }
+        if (read < count) {
+            free(samples);
+            break;
+        }
+        xbaseline_store(baseline, name, samples, count, (xmark_processed){(uint64_t)bytes, (uint64_t)items});
+    }
+    fclose(file);
+    return xtrue;
+}
+
+// Writes the benchmarks recorded this run into a baseline file, keeping the
+// ones of the file that did not run this time
+static void xbaseline_save(xbaseline* recorded, const char* path) {
+    xbaseline merged = {xnullptr, 0, 0};
+    xbaseline_load(&merged, path);
+    for (size_t i = 0; i < recorded->count; i++) {
+        double* samples = (double*)malloc(recorded->entries[i].count * sizeof(double));
+        if (!samples) {
+            xconsole_out("red", "Error: unable to allocate the benchmark baseline.\n");
+            exit(EXIT_FAILURE);
+        }
+        memcpy(samples, recorded->entries[i].samples, recorded->entries[i].count * sizeof(double));
+        xbaseline_store(&merged, recorded->entries[i].name, samples, recorded->entries[i].count, recorded->entries[i].processed);
+    }
+
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        xconsole_out("orange", "Notice: unable to write baseline file %s\n", path);
+        xbaseline_erase(&merged);
+        return;
+    }
+    fprintf(file, "# xtest baseline: <name> <samples> <bytes> <items> <nanoseconds per iteration>...\n");
+    for (size_t i = 0; i < merged.count; i++) {
+        fprintf(file, "%s %u %llu %llu", merged.entries[i].name, merged.entries[i].count,
+                (unsigned long long)merged.entries[i].processed.bytes, (unsigned long long)merged.entries[i].processed.items);
+        for (uint32_t s = 0; s < merged.entries[i].count; s++) {
+            fprintf(file, " %.9g", merged.entries[i].samples[s]);
+        }
+        fprintf(file, "\n");
+    }
+    fclose(file);
+    xbaseline_erase(&merged);
+}
+
+// Sample tagged with the distribution it came from, for ranking
+typedef struct {
+    double value;
+    uint8_t current;  // Set for samples of this run, clear for the baseline
+} xranked;
+
+static int xranked_compare(const void* lhs, const void* rhs) {
+    double a = ((const xranked*)lhs)->value;
+    double b = ((const xranked*)rhs)->value;
+    return (a > b) - (a < b);
+}
+
+// Two sided p-value of the Mann-Whitney U test that both sets of samples
+// come from the same distribution, by the normal approximation with the
+// variance corrected for ties. It compares whole distributions rather than
+// means, so a few outliers from a noisy machine do not decide it.
+static double xbaseline_mann_whitney(const double* before, uint32_t n1, const double* after, uint32_t n2) {
+    uint32_t n = n1 + n2;
+    xranked* ranked = (xranked*)malloc(n * sizeof(xranked));
+    if (!ranked) {
+        xconsole_out("red", "Error: unable to allocate the benchmark baseline.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = 0; i < n1; i++) {
+        ranked[i] = (xranked){before[i], 0};
+    }
+    for (uint32_t i = 0; i < n2; i++) {
+        ranked[n1 + i] = (xranked){after[i], 1};
+    }
+    qsort(ranked, n, sizeof(xranked), xranked_compare);
+
+    // tied samples share the average of the ranks they span
+    double rank_sum = 0.0;
+    double ties = 0.0;
+    for (uint32_t i = 0; i < n;) {
+        uint32_t j = i + 1;
+        while (j < n && ranked[j].value == ranked[i].value) {
+            j++;
+        }
+        double rank = (double)(i + 1 + j) / 2.0;
+        double t = (double)(j - i);
+        ties += t * t * t - t;
+        for (uint32_t k = i; k < j; k++) {
+            rank_sum += ranked[k].current ? rank : 0.0;
+        }
+        i = j;
+    }
+    free(ranked);
+
+    double u = rank_sum - (double)n2 * (n2 + 1) / 2.0;
+    double mean = (double)n1 * n2 / 2.0;
+    double variance = (double)n1 * n2 / 12.0 * ((n + 1) - ties / ((double)n * (n - 1)));
+    if (variance <= 0.0) {
+        return 1.0; // every sample is the same
+    }
+    double distance = fabs(u - mean) - 0.5; // continuity correction
+    double z = (distance > 0.0 ? distance : 0.0) / sqrt(variance);
+    return erfc(z / sqrt(2.0));
+}
+
+// Set when both runs of a benchmark declared the work of an iteration, bytes
+// are preferred over items when both kinds were declared
+static xbool xbaseline_by_rate(const xbaseline_entry* before, const xbaseline_entry* current, xbool* bytes) {
+    *bytes = before->processed.bytes > 0 && current->processed.bytes > 0;
+    return *bytes || (before->processed.items > 0 && current->processed.items > 0);
+}
+
+// Turns samples in nanoseconds per iteration into the throughput they stand
+// for, per second
+static double* xbaseline_rates(const double* samples, uint32_t count, uint64_t work) {
+    double* rates = (double*)malloc(count * sizeof(double));
+    if (!rates) {
+        xconsole_out("red", "Error: unable to allocate the benchmark baseline.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        rates[i] = samples[i] > 0.0 ? (double)work * 1e9 / samples[i] : 0.0;
+    }
+    return rates;
+}
+
+// Formats a median of the compared metric with its unit
+static void xbaseline_format(char* text, size_t size, double median, xbool rate, xbool bytes) {
+    static const char* const byte_units[] = {"B/s", "KB/s", "MB/s", "GB/s", "TB/s"};
+    static const char* const item_units[] = {"items/s", "K items/s", "M items/s", "G items/s", "T items/s"};
+    double value = 0.0;
+    const char* unit = rate ? xmark_rate_unit(median, bytes ? byte_units : item_units, &value) : xmark_unit(median, &value);
+    snprintf(text, size, "%.2f %s", value, unit);
+}
+
+// Compares the benchmarks of this run with a baseline file and prints the
+// delta of their medians. Benchmarks that declared the work an iteration
+// does in both runs are compared by throughput, so a change of input size
+// between the runs does not read as a change of speed, the others by time.
+// A benchmark regressed when it got worse by more than --mark-threshold
+// percent and the difference is significant.
+static void xbaseline_compare(const char* path) {
+    xbaseline baseline = {xnullptr, 0, 0};
+    if (!xbaseline_load(&baseline, path)) {
+        xconsole_out("orange", "Notice: unable to read baseline file %s, nothing to compare against.\n", path);
+        return;
+    }
+
+    xconsole_out("blue", "[Baseline Compare: Fossil Test]: %s, threshold %.1f%%\n", path, xcli.mark_threshold);
+    for (size_t i = 0; i < XBASELINE.count; i++) {
+        const xbaseline_entry* current = &XBASELINE.entries[i];
+        const xbaseline_entry* before = xbaseline_find(&baseline, current->name);
+        char now_text[32];
+        char then_text[32];
+        if (!before) {
+            xbaseline_format(now_text, sizeof(now_text), xmark_percentile(current->samples, current->count, 0.50), xfalse, xfalse);
+            xconsole_out("cyan", "> - %s: %s, not in the baseline\n", current->name, now_text);
+            continue;
+        }
+
+        xbool bytes = xfalse;
+        xbool rate = xbaseline_by_rate(before, current, &bytes);
+        const double* then_samples = before->samples;
+        const double* now_samples = current->samples;
+        double* then_rates = xnullptr;
+        double* now_rates = xnullptr;
+        if (rate) {
+            // rates come out in descending order from ascending times
+            then_rates = xbaseline_rates(before->samples, before->count, bytes ? before->processed.bytes : before->processed.items);
+            now_rates = xbaseline_rates(current->samples, current->count, bytes ? current->processed.bytes : current->processed.items);
+            qsort(then_rates, before->count, sizeof(double), xmark_compare_double);
+            qsort(now_rates, current->count, sizeof(double), xmark_compare_double);
+            then_samples = then_rates;
+            now_samples = now_rates;
+        }
+
+        double then = xmark_percentile(then_samples, before->count, 0.50);
+        double now = xmark_percentile(now_samples, current->count, 0.50);
+        double delta = then > 0.0 ? (now - then) / then * 100.0 : 0.0;
+        double worse = rate ? -delta : delta;
+        double p = xbaseline_mann_whitney(then_samples, before->count, now_samples, current->count);
+        xbaseline_format(then_text, sizeof(then_text), then, rate, bytes);
+        xbaseline_format(now_text, sizeof(now_text), now, rate, bytes);
+        free(then_rates);
+        free(now_rates);
+
+        const char* verdict = "unchanged";
+        xstring color = "cyan";
+        if (p < MARK_ALPHA && worse > xcli.mark_threshold) {
+            verdict = "REGRESSED";
+            color = "red";
+            XMARK_REGRESSIONS++;
+        } else if (p < MARK_ALPHA && worse < -xcli.mark_threshold) {
+            verdict = "improved";
+            color = "green";
+        }
+        xconsole_out(color, "> - %s: %s -> %s, %+.1f%%, p = %.4f, %s\n",
+                     current->name, then_text, now_text, delta, p, verdict);
+    }
+    xconsole_out("blue", "***************************:\n");
+    xbaseline_erase(&baseline);
+}
+
+// ==============================================================================
+// Xtest shuffled order
+// ==============================================================================
+
+// Next number of a splitmix64 sequence, small and good enough to permute a
+// registry while staying the same on every platform for a given seed
+static uint64_t xshuffle_next(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Seed used when --shuffle is given without one
+static uint64_t xshuffle_seed(void) {
+    uint64_t state = xtest_nanos() ^ ((uint64_t)time(xnullptr) << 20);
+#if defined(_WIN32)
+    state ^= (uint64_t)GetCurrentProcessId() << 40;
+#else
+    state ^= (uint64_t)getpid() << 40;
+#endif
+    return xshuffle_next(&state) % 1000000000ULL; // short enough to type back
+}
+
+// Puts the test cases of the registry in the order drawn from seed, a
+// Fisher-Yates pass so every order is equally likely
+static void xtest_shuffle(xregistry* registry, uint64_t seed) {
+    uint32_t* order = (uint32_t*)malloc((registry->count ? registry->count : 1) * sizeof(uint32_t));
+    if (!order) {
+        xconsole_out("red", "Error: unable to allocate the shuffled order.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = 0; i < registry->count; i++) {
+        order[i] = i;
+    }
+    uint64_t state = seed;
+    for (uint32_t i = registry->count; i > 1; i--) {
+        uint32_t k = (uint32_t)(xshuffle_next(&state) % i);
+        uint32_t swap = order[i - 1];
+        order[i - 1] = order[k];
+        order[k] = swap;
+    }
+    xregistry_reorder(registry, order, registry->count);
+    free(order);
+}
+
+static int xoutcome_compare_test(const void* lhs, const void* rhs) {
+    uintptr_t a = (uintptr_t)((const xoutcome*)lhs)->test;
+    uintptr_t b = (uintptr_t)((const xoutcome*)rhs)->test;
+    return (a > b) - (a < b);
+}
+
+// Keeps the selected test cases so every order starts from the same one
+static void xshuffle_start(xregistry* registry) {
+    uint32_t count = registry->count;
+    XSHUFFLE.entries  = (xentry*)malloc(count * sizeof(xentry));
+    XSHUFFLE.tests    = (xtest**)malloc(count * sizeof(xtest*));
+    XSHUFFLE.outcomes = (xoutcome*)calloc(count, sizeof(xoutcome));
+    if (!XSHUFFLE.entries || !XSHUFFLE.tests || !XSHUFFLE.outcomes) {
+        xconsole_out("red", "Error: unable to allocate the shuffled runs.\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(XSHUFFLE.entries, registry->entries, count * sizeof(xentry));
+    memcpy(XSHUFFLE.tests, registry->tests, count * sizeof(xtest*));
+    for (uint32_t i = 0; i < count; i++) {
+        XSHUFFLE.outcomes[i].test = registry->tests[i];
+    }
+    qsort(XSHUFFLE.outcomes, count, sizeof(xoutcome), xoutcome_compare_test);
+    XSHUFFLE.count = count;
+}
+
+// Puts the registry back the way xshuffle_start found it, the flags the
+// previous order left behind included
+static void xshuffle_restore(xregistry* registry) {
+    memcpy(registry->entries, XSHUFFLE.entries, XSHUFFLE.count * sizeof(xentry));
+    memcpy(registry->tests, XSHUFFLE.tests, XSHUFFLE.count * sizeof(xtest*));
+}
+
+// Adds the outcome of every test case in the order drawn from seed
+static void xshuffle_record(xregistry* registry, uint64_t seed) {
+    for (uint32_t i = 0; i < registry->count; i++) {
+        if (!(registry->entries[i].flags & XTEST_FLAG_FAILED)) {
+            continue;
+        }
+        xoutcome key = {registry->tests[i], 0, 0};
+        xoutcome* outcome = (xoutcome*)bsearch(&key, XSHUFFLE.outcomes, XSHUFFLE.count, sizeof(xoutcome), xoutcome_compare_test);
+        if (outcome && outcome->failures++ == 0) {
+            outcome->seed = seed;
+        }
+    }
+    XSHUFFLE.runs++;
+}
+
+// Lists the test cases that passed in some orders and failed in others
+static void xshuffle_report(void) {
+    for (uint32_t i = 0; i < XSHUFFLE.count; i++) {
+        uint32_t failures = XSHUFFLE.outcomes[i].failures;
+        XSHUFFLE.dependent += (failures > 0 && failures < XSHUFFLE.runs) ? 1 : 0;
+    }
+
+    xconsole_out("blue", "[Shuffle Report: Fossil Test]: %u orders, %u order dependent test cases\n", XSHUFFLE.runs, XSHUFFLE.dependent);
+    for (uint32_t i = 0; i < XSHUFFLE.count; i++) {
+        const xoutcome* outcome = &XSHUFFLE.outcomes[i];
+        if (outcome->failures > 0 && outcome->failures < XSHUFFLE.runs) {
+            xconsole_out("red", "> - %s: failed in %u of %u orders, replay with --shuffle=%llu\n",
+                         outcome->test->name, outcome->failures, XSHUFFLE.runs, (unsigned long long)outcome->seed);
+        }
+    }
+    xconsole_out("blue", "***************************:\n");
+
+    free(XSHUFFLE.entries);
+    free(XSHUFFLE.tests);
+    free(XSHUFFLE.outcomes);
+    XSHUFFLE.entries  = xnullptr;
+    XSHUFFLE.tests    = xnullptr;
+    XSHUFFLE.outcomes = xnullptr;
+}
+
+// ==============================================================================
+// Xtest internal argument parser logic
+// ==============================================================================
+
+// Function to check if an argument matches a specific option
+static xbool xparser_is_option(const xstring arg, const xstring option) {
+    return strcmp(arg, option) == 0;
+}
+
+// Number of cores available for the --jobs 0 shortcut
+static uint16_t xparser_core_count(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (uint16_t)info.dwNumberOfProcessors;
+#else
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return (cores > 0) ? (uint16_t)cores : MIN_JOBS;
+#endif
+}
+
+// Parses a duration such as 500ms, 90s, 30m, 2h or 1d, a bare number is in
+// seconds
+static xbool xparser_duration(const char* text, double* seconds) {
+    char* unit = xnullptr;
+    double value = strtod(text, &unit);
+    if (unit == text || value <= 0.0) {
+        return xfalse;
+    }
+    if (strcmp(unit, "ms") == 0) {
+        value /= 1000.0;
+    } else if (strcmp(unit, "m") == 0) {
+        value *= 60.0;
+    } else if (strcmp(unit, "h") == 0) {
+        value *= 3600.0;
+    } else if (strcmp(unit, "d") == 0) {
+        value *= 86400.0;
+    } else if (strcmp(unit, "") != 0 && strcmp(unit, "s") != 0) {
+        return xfalse;
+    }
+    *seconds = value;
+    return xtrue;
 }
 
 // Original xparser_parse_args function
@@ -613,64 +4122,226 @@ static void xparser_parse_args(int argc, xstring argv[]) {
     xcli.verbose   = xfalse;
     xcli.dry_run   = xfalse;
     xcli.repeat    = xfalse;
+    xcli.iter_repeat = 1;
     xcli.debug     = xfalse;
     xcli.color     = xfalse;
     xcli.only_test = xfalse;
     xcli.only_mark = xfalse;
     xcli.ci        = xfalse;
+    xcli.jobs      = MIN_JOBS;
+    xcli.isolate   = xfalse;
+    xcli.history   = xnullptr;
+    xcli.default_cost = DEFAULT_COST_MS;
+    xcli.shard_index  = 1;
+    xcli.shard_count  = 1;
+    xcli.fail_fast    = 0;
+    xcli.timeout      = 0;
+    xcli.repeat_for   = 0.0;
+    xcli.shuffle      = xfalse;
+    xcli.shuffle_seed = 0;
+    xcli.shuffle_runs = 0;
+    xcli.mark_time    = DEFAULT_MARK_TIME_MS;
+    xcli.mark_samples = DEFAULT_MARK_SAMPLES;
+    xcli.mark_counters = xfalse;
+    xcli.mark_clock   = XMARK_CLOCK_MONOTONIC;
+    xcli.mark_baseline  = xnullptr;
+    xcli.mark_compare   = xnullptr;
+    xcli.mark_threshold = DEFAULT_MARK_THRESHOLD;
+    xbool jobs_given  = xfalse;
+    xbool seed_given  = xfalse;
 
     for (int32_t i = 1; i < argc; i++) {
-        if (xparser_has_option(argc, argv, "--dry-run")) {
+        if (xparser_is_option(argv[i], "--dry-run")) {
             xcli.dry_run = xtrue;
-        } else if (xparser_has_option(argc, argv, "--cutback")) {
+        } else if (xparser_is_option(argv[i], "--cutback")) {
             xcli.cutback = xtrue;
             xcli.verbose = xfalse;
-        } else if (xparser_has_option(argc, argv, "--verbose")) {
+        } else if (xparser_is_option(argv[i], "--verbose")) {
             xcli.ci = xtrue;
-        }else if (xparser_has_option(argc, argv, "--debug")) {
+        }else if (xparser_is_option(argv[i], "--debug")) {
             xcli.debug = xtrue;
-        } else if (xparser_has_option(argc, argv, "--color")) {
+        } else if (xparser_is_option(argv[i], "--color")) {
             xcli.color = xtrue;
-        } else if (xparser_has_option(argc, argv, "--human")) {
+        } else if (xparser_is_option(argv[i], "--human")) {
             xcli.color = xtrue;
             xcli.verbose = xtrue;
-        } else if (xparser_has_option(argc, argv, "--ci")) {
+        } else if (xparser_is_option(argv[i], "--ci")) {
             xcli.ci = xtrue;
-        } else if (xparser_has_option(argc, argv, "--only-test")) {
+        } else if (xparser_is_option(argv[i], "--only-test")) {
             xcli.only_test = xtrue;
             xcli.only_fish = xfalse;
             xcli.only_mark = xfalse;
-        } else if (xparser_has_option(argc, argv, "--only-fish")) {
+        } else if (xparser_is_option(argv[i], "--only-fish")) {
             xcli.only_fish = xtrue;
             xcli.only_mark = xfalse;
             xcli.only_test = xfalse;
-        } else if (xparser_has_option(argc, argv, "--only-mark")) {
+        } else if (xparser_is_option(argv[i], "--only-mark")) {
             xcli.only_mark = xtrue;
             xcli.only_fish = xfalse;
             xcli.only_test = xfalse;
-        } else if (xparser_has_option(argc, argv, "--version") || xparser_has_option(argc, argv, "-v")) {
+        } else if (xparser_is_option(argv[i], "--version") || xparser_is_option(argv[i], "-v")) {
             xconsole_out("blue", "2.2.0\n");
             exit(EXIT_SUCCESS);
-        } else if (xparser_has_option(argc, argv, "--tip") || xparser_has_option(argc, argv, "-t")) {
+        } else if (xparser_is_option(argv[i], "--tip") || xparser_is_option(argv[i], "-t")) {
             xconsole_out("blue", "%s\n", helpful_tester_tip());
             exit(EXIT_SUCCESS);
-        } else if (xparser_has_option(argc, argv, "--help") || xparser_has_option(argc, argv, "-h")) {
+        } else if (xparser_is_option(argv[i], "--help") || xparser_is_option(argv[i], "-h")) {
             output_usage_format();
             exit(EXIT_SUCCESS);
-        } else if (xparser_has_option(argc, argv, "--repeat")) {
+        } else if (xparser_is_option(argv[i], "--repeat")) {
             xcli.repeat = xtrue;
             if (++i < argc) {
-                int iter_repeat = atoi(argv[i]);
-                if (iter_repeat >= MIN_REPEATS && iter_repeat <= MAX_REPEATS) {
-                    xcli.iter_repeat = iter_repeat;
+                char* end = xnullptr;
+                unsigned long long iter_repeat = strtoull(argv[i], &end, 10);
+                if (*end == '\0' && argv[i][0] != '-' && iter_repeat >= MIN_REPEATS && iter_repeat <= MAX_REPEATS) {
+                    xcli.iter_repeat = (uint32_t)iter_repeat;
                 } else {
-                    xconsole_out("red", "Error: --repeat value must be between 1 and 100.\n");
+                    xconsole_out("red", "Error: --repeat value must be between 1 and %u.\n", MAX_REPEATS);
                     exit(EXIT_FAILURE);
                 }
             } else {
                 xconsole_out("red", "Error: --repeat option requires a numeric argument.\n");
                 exit(EXIT_FAILURE);
             }
+        } else if (xparser_is_option(argv[i], "--repeat-for")) {
+            xcli.repeat = xtrue;
+            if (++i < argc && xparser_duration(argv[i], &xcli.repeat_for)) {
+                xcli.iter_repeat = xcli.iter_repeat ? xcli.iter_repeat : 1;
+            } else {
+                xconsole_out("red", "Error: --repeat-for option requires a duration such as 90s, 30m or 2h.\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (xparser_is_option(argv[i], "--isolate=fork")) {
+            xcli.isolate = xtrue;
+        } else if (xparser_is_option(argv[i], "--isolate=none")) {
+            xcli.isolate = xfalse;
+        } else if (xparser_is_option(argv[i], "--history")) {
+            if (++i < argc) {
+                xcli.history = argv[i];
+            } else {
+                xconsole_out("red", "Error: --history option requires a file name.\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (xparser_is_option(argv[i], "--default-cost")) {
+            if (++i < argc && atof(argv[i]) >= 0.0) {
+                xcli.default_cost = atof(argv[i]);
+            } else {
+                xconsole_out("red", "Error: --default-cost option requires a duration in milliseconds.\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (xparser_is_option(argv[i], "--shard")) {
+            unsigned int index = 0;
+            unsigned int shards = 0;
+            if (++i < argc && sscanf(argv[i], "%u/%u", &index, &shards) == 2 && shards > 0 && index >= 1 && index <= shards) {
+                xcli.shard_index = index;
+                xcli.shard_count = shards;
+            } else {
+                xconsole_out("red", "Error: --shard option requires I/N with 1 <= I <= N.\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (xparser_is_option(argv[i], "--fail-fast")) {
+            xcli.fail_fast = 1;
+        } else if (strncmp(argv[i], "--fail-fast=", 12) == 0) {
+            int limit = atoi(argv[i] + 12);
+            if (limit >= 1) {
+                xcli.fail_fast = (uint32_t)limit;
+            } else {
+                xconsole_out("red", "Error: --fail-fast value must be at least 1.\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (xparser_is_option(argv[i], "--filter") || xparser_is_option(argv[i], "--exclude")) {
+            xbool include = xparser_is_option(argv[i], "--filter");
+            if (++i < argc && argv[i][0] != '\0') {
+                xfilter_add(include ? &XFILTER_INCLUDE : &XFILTER_EXCLUDE, argv[i]);
+            } else {
+                xconsole_out("red", "Error: %s option requires a pattern.\n", include ? "--filter" : "--exclude");
+                exit(EXIT_FAILURE);
+            }
+        } else if (xparser_is_option(argv[i], "--timeout")) {
+            if (++i < argc && atoi(argv[i]) > 0) {
+                xcli.timeout = (uint32_t)atoi(argv[i]);
+            } else {
+                xconsole_out("red", "Error: --timeout option requires a positive number of milliseconds.\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (xparser_is_option(argv[i], "--shuffle")) {
+            xcli.shuffle = xtrue;
+        } else if (strncmp(argv[i], "--shuffle=", 10) == 0) {
+            char* end = xnullptr;
+            xcli.shuffle_seed = strtoull(argv[i] + 10, &end, 10);
+            if (argv[i][10] == '\0' || argv[i][10] == '-' || *end != '\0') {
+                xconsole_out("red", "Error: --shuffle seed must be a non-negative number.\n");
+                exit(EXIT_FAILURE);
+            }
+            xcli.shuffle = xtrue;
+            seed_given = xtrue;
+        } else if (xparser_is_option(argv[i], "--shuffle-runs")) {
+            if (++i < argc && atoi(argv[i]) >= 1) {
+                xcli.shuffle_runs = (uint32_t)atoi(argv[i]);
+                xcli.shuffle = xtrue;
+            } else {
+                xconsole_out("red", "Error: --shuffle-runs option requires a positive number of orders.\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (xparser_is_option(argv[i], "--mark-time")) {
+            if (++i < argc && atof(argv[i]) > 0.0) {
+                xcli.mark_time = atof(argv[i]);
+            } else {
+                xconsole_out("red", "Error: --mark-time option requires a positive number of milliseconds.\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (xparser_is_option(argv[i], "--mark-counters")) {
+            xcli.mark_counters = xtrue;
+        } else if (xparser_is_option(argv[i], "--mark-save-baseline") || xparser_is_option(argv[i], "--mark-compare")) {
+            xbool save = xparser_is_option(argv[i], "--mark-save-baseline");
+            if (++i < argc) {
+                *(save ? &xcli.mark_baseline : &xcli.mark_compare) = argv[i];
+            } else {
+                xconsole_out("red", "Error: %s option requires a file name.\n", save ? "--mark-save-baseline" : "--mark-compare");
+                exit(EXIT_FAILURE);
+            }
+        } else if (xparser_is_option(argv[i], "--mark-threshold")) {
+            if (++i < argc && atof(argv[i]) >= 0.0 && (atof(argv[i]) > 0.0 || strcmp(argv[i], "0") == 0)) {
+                xcli.mark_threshold = atof(argv[i]);
+            } else {
+                xconsole_out("red", "Error: --mark-threshold option requires a percentage.\n");
+                exit(EXIT_FAILURE);
+            }
+        } else if (strncmp(argv[i], "--mark-clock=", 13) == 0) {
+            const xstring clocks[] = {"monotonic", "raw", "thread-cpu", "tsc"};
+            uint8_t clock = 0;
+            while (clock < 4 && strcmp(argv[i] + 13, clocks[clock]) != 0) {
+                clock++;
+            }
+            if (clock == 4) {
+                xconsole_out("red", "Error: --mark-clock must be one of tsc, monotonic, raw or thread-cpu.\n");
+                exit(EXIT_FAILURE);
+            }
+            xcli.mark_clock = clock;
+        } else if (xparser_is_option(argv[i], "--mark-samples")) {
+            int samples = (++i < argc) ? atoi(argv[i]) : 0;
+            if (samples >= (int)MIN_MARK_SAMPLES && samples <= (int)MAX_MARK_SAMPLES) {
+                xcli.mark_samples = (uint32_t)samples;
+            } else {
+                xconsole_out("red", "Error: --mark-samples value must be between %u and %u.\n", MIN_MARK_SAMPLES, MAX_MARK_SAMPLES);
+                exit(EXIT_FAILURE);
+            }
+        } else if (xparser_is_option(argv[i], "--jobs")) {
+            jobs_given = xtrue;
+            if (++i < argc) {
+                int jobs = atoi(argv[i]);
+                if (jobs == 0 && strcmp(argv[i], "0") == 0) {
+                    xcli.jobs = xparser_core_count();
+                } else if (jobs >= MIN_JOBS && jobs <= MAX_JOBS) {
+                    xcli.jobs = jobs;
+                } else {
+                    xconsole_out("red", "Error: --jobs value must be between 0 and 256.\n");
+                    exit(EXIT_FAILURE);
+                }
+            } else {
+                xconsole_out("red", "Error: --jobs option requires a numeric argument.\n");
+                exit(EXIT_FAILURE);
+            }
         }
 
         // Check if the program is running in CI mode
@@ -681,43 +4352,315 @@ static void xparser_parse_args(int argc, xstring argv[]) {
             xcli.debug = xfalse;
         }
     }
+
+    // the seed is picked once and printed in the summary so the order can be replayed
+    if (xcli.shuffle && !seed_given) {
+        xcli.shuffle_seed = xshuffle_seed();
+    }
+
+    // a soak run uses every core unless told otherwise
+    if (xcli.repeat_for > 0.0 && !jobs_given) {
+        xcli.jobs = xparser_core_count();
+    }
+
+    // samples taken in a worker process never make it back to the parent
+    if (xcli.isolate && (xcli.mark_baseline || xcli.mark_compare)) {
+        xconsole_out("orange", "Notice: benchmarks run under --isolate are left out of --mark-save-baseline and --mark-compare.\n");
+    }
+
+    // the benchmark clock is checked and calibrated before anything is timed
+    xmark_clock_setup();
+
+    // patterns are compiled once here, before any test case is looked at
+    xfilter_compile(&XFILTER_INCLUDE, "--filter");
+    xfilter_compile(&XFILTER_EXCLUDE, "--exclude");
+} // end of func
+
+// ==============================================================================
+// Xtest create and erase
+// ==============================================================================
+
+// Initialization steps for the xengine runner
+xengine xtest_create(int argc, xstring *argv) {
+    // here we initialize the xengine runner starting with its declaration followed
+    // by the processing of the command line arguments
+    xengine runner;
+    xparser_parse_args(argc, argv);
+
+    // initialization of member variables for scoreboard, timer
+    runner.stats = (xstats){0, 0, 0, 0, 0, 0, 0, 0, 0};
+    runner.timer = (xtime){0, 0, 0};
+    runner.registry = (xregistry){xnullptr, xnullptr, 0, 0};
+
+    if (xcli.dry_run) { // Check if it's a dry run
+        xconsole_out("blue", "Simulating config step...\n");
+    }
+
+    // Measure the start time
+    runner.timer.start = xtest_clock();
+    
+    return runner;
+} // end of func
+
+// Runs the test cases at [first, end) of the table on a pool of threads
+static void xtest_run_threaded(xengine* engine, uint32_t first, uint32_t end, uint16_t jobs) {
+    xregistry* registry = &engine->registry;
+    uint32_t count = end;
+    xworker* workers = (xworker*)calloc(jobs, sizeof(xworker));
+    if (!workers) {
+        xconsole_out("red", "Error: unable to allocate %u workers.\n", jobs);
+        exit(EXIT_FAILURE);
+    }
+
+    // deal the registry out to the workers one unit at a time, then reverse
+    // each deque so that the tail each worker pops from holds its test cases
+    // in registry order. Test cases waiting on a prerequisite are left out,
+    // they are handed out as their prerequisites finish.
+    for (uint16_t i = 0; i < jobs; i++) {
+        workers[i].engine = engine;
+        workers[i].pool   = workers;
+        workers[i].count  = jobs;
+        workers[i].id     = i;
+#if !defined(_WIN32)
+        workers[i].running = XTEST_NONE;
+        pthread_mutex_init(&workers[i].lock, xnullptr);
+#endif
+    }
+    xbool graph = xgraph_build(registry, first, count);
+    uint32_t units = 0;
+    for (uint32_t index = first; index < count; ) {
+        uint32_t unit_end = xtest_unit_end(registry, index);
+        if (graph && XGRAPH.pending[index] > 0) {
+            index = unit_end;
+            continue;
+        }
+        for (; index < unit_end; index++) {
+            xdeque_push(&workers[units % jobs].deque, index);
+        }
+        units++;
+    }
+    for (uint16_t i = 0; i < jobs; i++) {
+        uint32_t* slots = workers[i].deque.slots;
+        for (uint32_t lo = 0, hi = workers[i].deque.tail; lo + 1 < hi; lo++, hi--) {
+            uint32_t swap = slots[lo];
+            slots[lo] = slots[hi - 1];
+            slots[hi - 1] = swap;
+        }
+    }
+
+    // timeouts need a thread to watch the workers, the calling thread does that
+    xbool supervised = xfalse;
+#if !defined(_WIN32)
+    for (uint32_t i = first; i < count && !supervised; i++) {
+        supervised = xtest_timeout(&registry->entries[i]) > 0;
+    }
+#endif
+
+    // with a single job the calling thread drains the deque by itself
+    uint16_t started = 0;
+#if !defined(_WIN32)
+    if (jobs > 1 || supervised) {
+        for (; started < jobs; started++) {
+            workers[started].supervised = supervised;
+            if (pthread_create(&workers[started].thread, xnullptr, xtest_worker_main, &workers[started]) != 0) {
+                break; // the workers that did start steal the rest of the work
+            }
+        }
+    }
+#endif
+    if (started == 0) {
+        workers[0].supervised = xfalse;
+        xtest_worker_main(&workers[0]);
+    }
+
+    uint32_t abandoned = 0;
+#if !defined(_WIN32)
+    if (supervised && started > 0) {
+        abandoned = xtest_watchdog(workers, started);
+    }
+    for (uint16_t i = 0; i < started; i++) {
+        if (!workers[i].abandoned) {
+            pthread_join(workers[i].thread, xnullptr);
+        }
+    }
+#endif
+
+    for (uint16_t i = 0; i < jobs; i++) {
+        // whatever is left in a deque was abandoned by fail-fast or by a
+        // worker no relief thread could be started for
+        workers[i].stats.unrun_count += workers[i].deque.tail - workers[i].deque.head;
+        xtest_merge_worker(engine, &workers[i]);
+    }
+    if (graph) {
+        // and so were the test cases still waiting on a prerequisite
+        for (uint32_t i = first; i < count; i++) {
+            engine->stats.unrun_count += (XGRAPH.pending[i] > 0) ? 1 : 0;
+        }
+        xgraph_erase();
+    }
+
+    // abandoned threads may still wake up and touch their worker, so the
+    // workers are only released when every thread has been accounted for
+    if (abandoned == 0) {
+#if !defined(_WIN32)
+        for (uint16_t i = 0; i < jobs; i++) {
+            pthread_mutex_destroy(&workers[i].lock);
+        }
+#endif
+        for (uint16_t i = 0; i < jobs; i++) {
+            free(workers[i].deque.slots);
+        }
+        free(workers);
+    }
 } // end of func
 
-// ==============================================================================
-// Xtest create and erase
-// ==============================================================================
-
-// Initialization steps for the xengine runner
-xengine xtest_create(int argc, xstring *argv) {
-    // here we initialize the xengine runner starting with its declaration followed
-    // by the processing of the command line arguments
-    xengine runner;
-    xparser_parse_args(argc, argv);
-
-    // initialization of member variables for scoreboard, timer
-    runner.stats = (xstats){0, 0, 0, 0, 0, 0, 0, 0};
-    runner.timer = (xtime){0, 0, 0};
-    runner.queue = xqueue_create();
+// Runs every test case of the registry once, picking the runner each kind
+// of test case needs
+static void xtest_dispatch(xengine* engine, uint16_t jobs) {
+    xregistry* registry = &engine->registry;
 
-    if (xcli.dry_run) { // Check if it's a dry run
-        xconsole_out("blue", "Simulating config step...\n");
+    // async test cases share one event loop on the calling thread, always in
+    // process, snapshot fixtures fork from the calling thread while it is
+    // running no worker thread, and the rest of the registry goes to the workers afterwards
+    uint32_t first = 0;
+#if defined(XTEST_ASYNC_LOOP)
+    uint32_t async = xtest_partition(registry, first, XTEST_FLAG_ASYNC);
+    if (async > 0) {
+        xtest_run_async(engine, first, first + async);
+    }
+    first += async;
+#endif
+#if !defined(_WIN32)
+    uint32_t snapshots = xtest_partition(registry, first, XTEST_FLAG_SNAPSHOT);
+    if (snapshots > 0) {
+        xtest_run_snapshots(engine, first, first + snapshots, jobs);
     }
+    first += snapshots;
+#endif
 
-    // Measure the start time
-    runner.timer.start = clock() / (double)CLOCKS_PER_SEC;
-    
-    return runner;
+    if (first < registry->count && xcli.isolate) {
+#if defined(_WIN32)
+        xconsole_out("orange", "Notice: --isolate=fork is not supported on this platform, running in process.\n");
+        xtest_run_threaded(engine, first, registry->count, jobs);
+#else
+        // the dependency graph is only scheduled by the worker threads
+        uint32_t graph = xtest_partition(registry, first, XTEST_FLAG_DEPENDS);
+        if (graph > 0) {
+            xtest_run_threaded(engine, first, first + graph, jobs);
+        }
+        first += graph;
+        if (first < registry->count) {
+            xtest_run_isolated(engine, first, jobs);
+        }
+#endif
+    } else if (first < registry->count) {
+        xtest_run_threaded(engine, first, registry->count, jobs);
+    }
 } // end of func
 
 // Run all test cases in the queue
 void xtest_run_queue(xengine* engine) {
-    // assuming that queue is not empty we run the test cases in the queue
-    while (!xqueue_is_empty(engine->queue)) {
-        xtest* current_test = xqueue_dequeue(engine->queue);
-        if (current_test != xnullptr) {
-            xtest_run_test(engine, current_test, xnullptr);
+    uint16_t jobs = xcli.jobs;
+
+#if defined(_WIN32)
+    if (jobs > 1) {
+        xconsole_out("orange", "Notice: --jobs is not supported on this platform, running serially.\n");
+        jobs = 1;
+    }
+    if (xcli.timeout > 0) {
+        xconsole_out("orange", "Notice: --timeout is not supported on this platform.\n");
+    }
+#endif
+
+    xregistry* registry = &engine->registry;
+    xtest_select(registry);
+    xfilter_erase(&XFILTER_INCLUDE);
+    xfilter_erase(&XFILTER_EXCLUDE);
+    if (registry->count == 0) {
+        return;
+    }
+
+    if (xcli.history) {
+        xhistory_load(&XHISTORY, xcli.history);
+    }
+    if (xcli.shard_count > 1) {
+        if (!xcli.history) {
+            xconsole_out("orange", "Notice: --shard without --history splits the test cases by count, not by recorded durations.\n");
+        }
+        xhistory_select_shard(&XHISTORY, registry, xcli.shard_index, xcli.shard_count);
+    }
+    xgraph_resolve(registry);
+    // a shuffled order replaces the longest first one, it is there to shake
+    // out test cases that lean on state left behind by the ones before them
+    if (xcli.history && !xcli.shuffle) {
+        if (jobs > 1) {
+            xhistory_sort_longest_first(&XHISTORY, registry);
+        }
+    }
+
+    uint32_t runs = xcli.shuffle_runs ? xcli.shuffle_runs : 1;
+    if (runs > 1) {
+        xshuffle_start(registry);
+    }
+    if (xcli.repeat) {
+        xsoak_start();
+    }
+    for (uint32_t run = 0; run < runs && !xtest_cancelled(); run++) {
+        // order run is drawn from seed + run, so --shuffle=<that seed>
+        // replays it on its own
+        uint64_t seed = xcli.shuffle_seed + run;
+        if (runs > 1) {
+            xshuffle_restore(registry);
         }
+        if (xcli.shuffle) {
+            xtest_shuffle(registry, seed);
+        }
+        xtest_group_fixtures(registry);
+
+        // a soak run keeps running rounds of the selected test cases until
+        // --repeat-for is over, sampling resource usage on the side
+        uint64_t soak_end = 0;
+        if (xcli.repeat_for > 0.0) {
+            soak_end = xtest_nanos() + (uint64_t)(xcli.repeat_for * 1e9);
+        }
+        do {
+            xtest_dispatch(engine, jobs);
+            XSOAK.rounds++;
+        } while (soak_end != 0 && xtest_nanos() < soak_end && !xtest_cancelled());
+
+        // an order cut short by --fail-fast says nothing about the cases it left out
+        if (runs > 1 && !xtest_cancelled()) {
+            xshuffle_record(registry, seed);
+        }
+    }
+    if (xcli.repeat) {
+        xsoak_stop();
+        xsoak_report();
+    }
+    if (runs > 1) {
+        xshuffle_report();
+    }
+
+    if (xcli.history) {
+        // cases cut off by a timeout, a crash, --fail-fast or a failed
+        // prerequisite keep the cost recorded by an earlier run
+        for (uint32_t i = 0; i < registry->count; i++) {
+            if (!(registry->entries[i].flags & XTEST_FLAG_RAN)) {
+                continue;
+            }
+            uint64_t micros = (uint64_t)registry->tests[i]->timer.elapsed * 1000000 / CLOCKS_PER_SEC;
+            xhistory_store(&XHISTORY, registry->tests[i]->name, micros);
+        }
+        xhistory_save(&XHISTORY, xcli.history);
+    }
+
+    if (xcli.mark_compare) {
+        xbaseline_compare(xcli.mark_compare);
+    }
+    if (xcli.mark_baseline) {
+        xbaseline_save(&XBASELINE, xcli.mark_baseline);
     }
+    xbaseline_erase(&XBASELINE);
 } // end of func
 
 // Deinitialization steps for the xengine runner
@@ -731,93 +4674,697 @@ int xtest_erase(xengine *runner) {
         output_summary_format(runner);
     }
 
-    // then we clean up the queue and free the memory allocated for the runner
-    xqueue_erase(runner->queue); // Erase the queue
+    // then we clean up the registry and free the memory allocated for the runner
+    xregistry_erase(&runner->registry); // Erase the registry
 
-    return runner->stats.failed_count;
+    // crashed test cases only count as errors, they fail the run all the same
+    return runner->stats.failed_count + runner->stats.error_count + XMARK_REGRESSIONS;
 } // end of func
 
 // ==============================================================================
 // Xtest essential test runner functions
 // ==============================================================================
 
-void xtest_run_as_test(xengine* engine, xtest* test_case) {
+// Settles the fixture and configuration of a test case being queued
+static void xtest_queue(xtest* test_case, const xfixture* fixture) {
     test_case->config.ignored   = xfalse;
-    test_case->fixture.setup    = xnullptr;
-    test_case->fixture.teardown = xnullptr;
+    test_case->config.queued    = xtrue;
+    test_case->fixture.setup    = fixture ? fixture->setup : xnullptr;
+    test_case->fixture.teardown = fixture ? fixture->teardown : xnullptr;
+    test_case->fixture.shared   = fixture ? fixture->shared : xfalse;
+    test_case->fixture.snapshot = fixture ? fixture->snapshot : xfalse;
+} // end of func
 
-    xqueue_enqueue(engine->queue, test_case);
+void xtest_run_as_test(xengine* engine, xtest* test_case) {
+    xtest_queue(test_case, xnullptr);
+    xregistry_push(&engine->registry, test_case);
 } // end of func
 
 void xtest_run_as_fixture(xengine* engine, xtest* test_case, xfixture* fixture) {
-    test_case->config.ignored   = xfalse;
-    test_case->fixture.setup    = fixture->setup;
-    test_case->fixture.teardown = fixture->teardown;
+    xtest_queue(test_case, fixture);
+    xregistry_push(&engine->registry, test_case);
+} // end of func
+
+// Queues every registered test case that is not queued yet, fixture cases in
+// the fixture their descriptor names. The registry grows once by the size of
+// the section and the unqueued cases are stored into it in section order.
+void xtest_run_registered(xengine* engine) {
+#if defined(XTEST_REGISTRY_SECTION)
+    if (__start_xtest_registry == xnullptr) {
+        return;
+    }
+    xregistry* registry = &engine->registry;
+    xregistry_reserve(registry, registry->count + (uint32_t)(__stop_xtest_registry - __start_xtest_registry));
+    for (const xregistered *entry = __start_xtest_registry; entry < __stop_xtest_registry; entry++) {
+        if (!entry->test_case->config.queued) {
+            xtest_queue(entry->test_case, entry->fixture);
+            xregistry_store(registry, entry->test_case);
+        }
+    }
+#else
+    (void)engine;
+#endif
+} // end of func
 
-    xqueue_enqueue(engine->queue, test_case);
+// Number of registered test cases that were defined but never queued
+static uint32_t xtest_count_unqueued(void) {
+    uint32_t unqueued = 0;
+#if defined(XTEST_REGISTRY_SECTION)
+    if (__start_xtest_registry != xnullptr) {
+        for (const xregistered *entry = __start_xtest_registry; entry < __stop_xtest_registry; entry++) {
+            unqueued += entry->test_case->config.queued ? 0 : 1;
+        }
+    }
+#endif
+    return unqueued;
 } // end of func
 
 // ==============================================================================
 // Xmark functions for benchmarks
 // ==============================================================================
 
-void xmark_start_benchmark() {
-#if defined(_WIN32)
-    LARGE_INTEGER freq;
-    QueryPerformanceFrequency(&freq);
-    frequency = (double)freq.QuadPart;
-    QueryPerformanceCounter((LARGE_INTEGER*)&start_time);
-#else
+#if !defined(_WIN32)
+static uint64_t xmark_clock_read(clockid_t clock) {
     struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    start_time = ts.tv_sec * 1e9 + ts.tv_nsec;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+#if defined(XMARK_TSC)
+// Reads the time stamp counter, the fences keep the instructions before and
+// after the read from being reordered across it by the processor
+static inline uint64_t xmark_tsc(void) {
+    _mm_lfence();
+    uint64_t ticks = __rdtsc();
+    _mm_lfence();
+    return ticks;
+}
+
+// Set when the counter ticks at a constant rate through frequency and power
+// state changes, CPUID leaf 0x80000007 EDX bit 8
+static xbool xmark_tsc_invariant(void) {
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0x80000000);
+    if ((unsigned)regs[0] < 0x80000007u) {
+        return xfalse;
+    }
+    __cpuid(regs, 0x80000007);
+    return (regs[3] & (1 << 8)) != 0;
+#else
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+        return xfalse;
+    }
+    return (edx & (1u << 8)) != 0;
+#endif
+}
+#endif
+
+// Reading of the benchmark clock in its own ticks, only differences of two
+// readings mean anything and xmark_ticks_to_nanos turns them into time
+static inline uint64_t xmark_stamp(void) {
+    switch (xcli.mark_clock) {
+#if defined(XMARK_TSC)
+    case XMARK_CLOCK_TSC:
+        return xmark_tsc();
 #endif
+#if !defined(_WIN32) && defined(CLOCK_MONOTONIC_RAW)
+    case XMARK_CLOCK_RAW:
+        return xmark_clock_read(CLOCK_MONOTONIC_RAW);
+#endif
+#if !defined(_WIN32) && defined(CLOCK_THREAD_CPUTIME_ID)
+    case XMARK_CLOCK_THREAD_CPU:
+        return xmark_clock_read(CLOCK_THREAD_CPUTIME_ID);
+#endif
+    default:
+        return xtest_nanos();
+    }
+}
+
+static inline double xmark_ticks_to_nanos(uint64_t ticks) {
+    return (double)ticks * XMARK_TICK_NS;
+}
+
+// Checks that the clock of --mark-clock exists here, falling back to the
+// monotonic clock when it does not, and measures the rate of the time stamp
+// counter against the monotonic clock over a few milliseconds
+static void xmark_clock_select(void) {
+    const char* fallback = xnullptr;
+    if (xcli.mark_clock == XMARK_CLOCK_TSC) {
+#if defined(XMARK_TSC)
+        if (xmark_tsc_invariant()) {
+            uint64_t mono_start = xtest_nanos();
+            uint64_t tsc_start = xmark_tsc();
+            while (xtest_nanos() - mono_start < 20000000ULL) {
+                // spin, sleeping could land the thread on another core
+            }
+            uint64_t tsc_end = xmark_tsc();
+            uint64_t mono_end = xtest_nanos();
+            if (tsc_end > tsc_start) {
+                XMARK_TICK_NS = (double)(mono_end - mono_start) / (double)(tsc_end - tsc_start);
+                return;
+            }
+        }
+        fallback = "this processor has no invariant time stamp counter";
+#else
+        fallback = "the time stamp counter is only read on x86";
+#endif
+    }
+#if defined(_WIN32) || !defined(CLOCK_MONOTONIC_RAW)
+    if (xcli.mark_clock == XMARK_CLOCK_RAW) {
+        fallback = "CLOCK_MONOTONIC_RAW is not available on this platform";
+    }
+#endif
+#if defined(_WIN32) || !defined(CLOCK_THREAD_CPUTIME_ID)
+    if (xcli.mark_clock == XMARK_CLOCK_THREAD_CPU) {
+        fallback = "CLOCK_THREAD_CPUTIME_ID is not available on this platform";
+    }
+#endif
+    if (fallback) {
+        xconsole_out("orange", "Notice: %s, benchmarks are timed with the monotonic clock.\n", fallback);
+        xcli.mark_clock = XMARK_CLOCK_MONOTONIC;
+    }
+    XMARK_TICK_NS = 1.0;
+}
+
+// Bytes and items each iteration of the next XMARK_LOOP of this test case processes
+void xmark_set_bytes_processed(uint64_t bytes) {
+    XMARK_PROCESSED.bytes = bytes;
+}
+
+void xmark_set_items_processed(uint64_t items) {
+    XMARK_PROCESSED.items = items;
+}
+
+// Picks the benchmark clock, then measures what reading it costs as the
+// least of a few hundred back to back readings
+static void xmark_clock_setup(void) {
+    xmark_clock_select();
+    uint64_t least = UINT64_MAX;
+    for (uint32_t i = 0; i < 256; i++) {
+        uint64_t start = xmark_stamp();
+        uint64_t ticks = xmark_stamp() - start;
+        least = ticks < least ? ticks : least;
+    }
+    XMARK_OVERHEAD_NS = xmark_ticks_to_nanos(least);
+}
+
+// Tells once per test case that a timing is too short to trust
+static void xmark_overhead_notice(const char* what, double nanos, double floor) {
+    if (XMARK_OVERHEAD_WARNED) {
+        return;
+    }
+    XMARK_OVERHEAD_WARNED = xtrue;
+    xconsole_out("orange", "Notice: %s of %s measured %.2f ns, below %.2f ns, the optimizer may have removed the work, see XMARK_KEEP.\n",
+                 what, XTEST_RUNNING ? XTEST_RUNNING->name : "benchmark", nanos, floor);
+}
+
+void xmark_keep(const volatile void* value) {
+    XMARK_SINK = value;
+}
+
+void xmark_clobber(void) {
+    // a call into another translation unit is all the barrier there is
+    // without inline asm, the compiler has to assume memory changed
+}
+
+// Starts a timer handle
+void xmark_timer_start(xmark_timer* timer) {
+    timer->start = xmark_stamp();
+    timer->lap = timer->start;
+}
+
+// Nanoseconds since the previous lap of a timer handle, or since its start
+uint64_t xmark_timer_lap(xmark_timer* timer) {
+    uint64_t now = xmark_stamp();
+    uint64_t elapsed = now - timer->lap;
+    timer->lap = now;
+    return (uint64_t)xmark_ticks_to_nanos(elapsed);
+}
+
+// Nanoseconds since a timer handle was started, it may go on running
+uint64_t xmark_timer_stop(xmark_timer* timer) {
+    timer->lap = xmark_stamp();
+    double elapsed = xmark_ticks_to_nanos(timer->lap - timer->start);
+    if (xcli.verbose && elapsed < XMARK_OVERHEAD_NS * XMARK_OVERHEAD_FACTOR) {
+        xmark_overhead_notice("timed region", elapsed, XMARK_OVERHEAD_NS * XMARK_OVERHEAD_FACTOR);
+    }
+    return (uint64_t)elapsed;
+}
+
+void xmark_start_benchmark() {
+    xmark_timer_start(&XMARK_TIMER);
 }
 
 uint64_t xmark_stop_benchmark() {
-#if defined(_WIN32)
-    LARGE_INTEGER end_time;
-    QueryPerformanceCounter(&end_time);
-    return (uint64_t)((end_time.QuadPart - start_time) * 1e9 / frequency);
+    return xmark_timer_stop(&XMARK_TIMER);
+}
+
+// Time since XMARK_START_BENCHMARK on this thread, in the given unit of nanoseconds
+static double xmark_elapsed(double unit) {
+    return xmark_ticks_to_nanos(xmark_stamp() - XMARK_TIMER.start) / unit;
+}
+
+static int xmark_compare_double(const void* lhs, const void* rhs) {
+    double a = *(const double*)lhs;
+    double b = *(const double*)rhs;
+    return (a > b) - (a < b);
+}
+
+// Percentile p of sorted samples, interpolating between the two closest ranks
+static double xmark_percentile(const double* sorted, uint32_t count, double p) {
+    double rank = p * (double)(count - 1);
+    uint32_t low = (uint32_t)rank;
+    if (low + 1 >= count) {
+        return sorted[count - 1];
+    }
+    return sorted[low] + (sorted[low + 1] - sorted[low]) * (rank - (double)low);
+}
+
+// Sorts the samples and summarizes them, samples outside the Tukey fences
+// 1.5 interquartile ranges beyond the quartiles count as outliers
+static void xmark_summarize(double* samples, uint32_t count, xmark_stats* stats) {
+    qsort(samples, count, sizeof(double), xmark_compare_double);
+
+    double sum = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+        sum += samples[i];
+    }
+    double mean = sum / count;
+    double squares = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+        squares += (samples[i] - mean) * (samples[i] - mean);
+    }
+
+    double q1 = xmark_percentile(samples, count, 0.25);
+    double q3 = xmark_percentile(samples, count, 0.75);
+    double low_fence = q1 - 1.5 * (q3 - q1);
+    double high_fence = q3 + 1.5 * (q3 - q1);
+
+    stats->min    = samples[0];
+    stats->median = xmark_percentile(samples, count, 0.50);
+    stats->mean   = mean;
+    stats->stddev = count > 1 ? sqrt(squares / (count - 1)) : 0.0;
+    stats->p90    = xmark_percentile(samples, count, 0.90);
+    stats->p99    = xmark_percentile(samples, count, 0.99);
+    stats->low_outliers  = 0;
+    stats->high_outliers = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        stats->low_outliers  += (samples[i] < low_fence) ? 1 : 0;
+        stats->high_outliers += (samples[i] > high_fence) ? 1 : 0;
+    }
+    stats->samples = count;
+}
+
+// Set once the notice about missing hardware counters has been printed
+static uint32_t XMARK_COUNTERS_NOTICED = 0;
+
+// Tells once per run why --mark-counters has nothing to report
+static void xcounters_notice(const char* reason) {
+    if (xatomic_add(&XMARK_COUNTERS_NOTICED, 1) == 1) {
+        xconsole_out("orange", "Notice: hardware counters are unavailable (%s), benchmarks report wall time only.\n", reason);
+    }
+}
+
+#if defined(XTEST_PERF_COUNTERS)
+// Opens one counter of the calling thread in user space, joined to the group
+// of leader or leading a new group when leader is -1
+static int xcounters_open_event(uint32_t type, uint64_t config, int leader) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = type;
+    attr.config         = config;
+    attr.disabled       = (leader == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+}
+#endif
+
+// Opens the counter group of the calling thread, the counters the PMU
+// refuses are left out and without cycles there is no group at all
+static void xcounters_open(xcounters* counters) {
+    *counters = (xcounters){xfalse, {-1, -1, -1, -1, -1}, {-1, -1, -1, -1, -1}, 0};
+#if defined(XTEST_PERF_COUNTERS)
+    const uint32_t types[XMARK_COUNTERS] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE};
+    const uint64_t configs[XMARK_COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+    for (uint8_t i = 0; i < XMARK_COUNTERS; i++) {
+        counters->fds[i] = xcounters_open_event(types[i], configs[i], counters->fds[XMARK_CYCLES]);
+        if (counters->fds[i] >= 0) {
+            counters->slots[i] = (int8_t)counters->members++;
+        } else if (i == XMARK_CYCLES) {
+            char reason[128];
+            snprintf(reason, sizeof(reason), "perf_event_open: %s, see /proc/sys/kernel/perf_event_paranoid", strerror(errno));
+            xcounters_notice(reason);
+            return;
+        }
+    }
+    counters->active = xtrue;
 #else
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return (ts.tv_sec * 1e9 + ts.tv_nsec) - start_time;
+    xcounters_notice("not supported on this platform");
+#endif
+}
+
+static void xcounters_close(xcounters* counters) {
+    for (uint8_t i = 0; counters->active && i < XMARK_COUNTERS; i++) {
+        if (counters->fds[i] >= 0) {
+            close(counters->fds[i]);
+        }
+    }
+    counters->active = xfalse;
+}
+
+// Zeroes the group and starts counting
+static void xcounters_start(xcounters* counters) {
+#if defined(XTEST_PERF_COUNTERS)
+    if (counters->active) {
+        ioctl(counters->fds[XMARK_CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(counters->fds[XMARK_CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#else
+    (void)counters;
+#endif
+}
+
+// Stops counting and stores the counts per iteration, scaled up when the
+// kernel had to multiplex the group with other users of the PMU
+static void xcounters_stop(xcounters* counters, uint64_t iterations, double* results) {
+    for (uint8_t i = 0; i < XMARK_COUNTERS; i++) {
+        results[i] = -1.0;
+    }
+#if defined(XTEST_PERF_COUNTERS)
+    if (!counters->active) {
+        return;
+    }
+    ioctl(counters->fds[XMARK_CYCLES], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    uint64_t values[3 + XMARK_COUNTERS]; // nr, time enabled, time running, counts
+    if (read(counters->fds[XMARK_CYCLES], values, sizeof(values)) < (ssize_t)(3 * sizeof(uint64_t)) || values[2] == 0) {
+        return; // never got onto the PMU
+    }
+    double scale = (double)values[1] / (double)values[2];
+    for (uint8_t i = 0; i < XMARK_COUNTERS; i++) {
+        if (counters->slots[i] >= 0 && (uint64_t)counters->slots[i] < values[0]) {
+            results[i] = (double)values[3 + counters->slots[i]] * scale / (double)iterations;
+        }
+    }
+#else
+    (void)counters;
+    (void)iterations;
+#endif
+}
+
+#if defined(XMARK_ALLOC_COUNTING)
+// The wrappers only touch the counters of the calling thread, so they stay
+// cheap outside of benchmarks and safe on any thread
+void* malloc(size_t size) {
+    if (XMARK_ALLOCS.active) {
+        XMARK_ALLOCS.allocs++;
+        XMARK_ALLOCS.bytes += size;
+    }
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    if (XMARK_ALLOCS.active) {
+        XMARK_ALLOCS.allocs++;
+        XMARK_ALLOCS.bytes += count * size;
+    }
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (XMARK_ALLOCS.active) {
+        XMARK_ALLOCS.allocs++;
+        XMARK_ALLOCS.bytes += size;
+    }
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    if (XMARK_ALLOCS.active && ptr) {
+        XMARK_ALLOCS.frees++;
+    }
+    __libc_free(ptr);
+}
+#endif
+
+// Stops counting allocations and stores them per iteration
+static void xmark_allocs_stop(uint64_t iterations, xmark_stats* stats) {
+    XMARK_ALLOCS.active = xfalse;
+#if defined(XMARK_ALLOC_COUNTING)
+    stats->allocs    = (double)XMARK_ALLOCS.allocs / (double)iterations;
+    stats->frees     = (double)XMARK_ALLOCS.frees / (double)iterations;
+    stats->allocated = (double)XMARK_ALLOCS.bytes / (double)iterations;
+#else
+    (void)iterations;
+    stats->allocs    = -1.0;
+    stats->frees     = -1.0;
+    stats->allocated = -1.0;
+#endif
+}
+
+#if !defined(XMARK_ALLOC_COUNTING)
+// Set once the notice about a budget that cannot be checked has been printed
+static uint32_t XMARK_BUDGET_NOTICED = 0;
+#endif
+
+// Declares the most allocations and bytes one iteration of the next
+// XMARK_LOOP of this test case may allocate
+void xmark_alloc_budget(double allocs, double bytes, const xstring file, int line, const xstring func) {
+    XMARK_BUDGET = (xmark_budget){xtrue, allocs, bytes, file, line, func};
+#if !defined(XMARK_ALLOC_COUNTING)
+    if (xatomic_add(&XMARK_BUDGET_NOTICED, 1) == 1) {
+        xconsole_out("orange", "Notice: allocations are only counted in glibc builds with -Dwith_alloc_hooks=enabled, XMARK_ALLOC_BUDGET is not checked.\n");
+    }
 #endif
 }
 
+// Fails the test case when its benchmark loop allocated past its budget
+static void xmark_budget_check(const xmark_stats* stats) {
+    if (!XMARK_BUDGET.set || stats->allocs < 0.0) {
+        return;
+    }
+    if (stats->allocs > XMARK_BUDGET.allocs || stats->allocated > XMARK_BUDGET.bytes) {
+        char message[192];
+        snprintf(message, sizeof(message), "allocation budget exceeded, %.2f allocs and %.2f bytes per iteration against %.2f and %.2f",
+                 stats->allocs, stats->allocated, XMARK_BUDGET.allocs, XMARK_BUDGET.bytes);
+        xassert(xfalse, message, (xstring)XMARK_BUDGET.file, XMARK_BUDGET.line, (xstring)XMARK_BUDGET.func);
+    }
+}
+
+// Starts the benchmark loop of XMARK_LOOP, returns the size of its first batch
+uint64_t xmark_loop_begin(void) {
+    xmark_loop* loop = &XMARK_STATE;
+    free(loop->samples); // left behind by a loop that was broken out of
+    xcounters_close(&loop->counters);
+    *loop = (xmark_loop){XMARK_CALIBRATE, 1, 0, 0, 0, xnullptr, 0, {xfalse, {-1, -1, -1, -1, -1}, {-1, -1, -1, -1, -1}, 0}};
+    if (xcli.mark_counters) {
+        xcounters_open(&loop->counters);
+    }
+    loop->target = (uint64_t)(xcli.mark_time * 1e6 / xcli.mark_samples);
+    loop->target = loop->target ? loop->target : 1;
+    XMARK_ALLOCS.active = xfalse;
+    loop->samples = (double*)malloc(xcli.mark_samples * sizeof(double));
+    if (!loop->samples) {
+        xconsole_out("red", "Error: unable to allocate the benchmark samples.\n");
+        exit(EXIT_FAILURE);
+    }
+    loop->start = xmark_stamp();
+    return loop->batch;
+}
+
+// Ends the batch in flight of XMARK_LOOP, returns the size of the next one or
+// zero once every sample has been taken and reported
+uint64_t xmark_loop_next(void) {
+    uint64_t elapsed = (uint64_t)xmark_ticks_to_nanos(xmark_stamp() - XMARK_STATE.start);
+    xmark_loop* loop = &XMARK_STATE;
+
+    if (loop->phase == XMARK_CALIBRATE) {
+        if (elapsed >= loop->target || loop->batch >= XMARK_MAX_BATCH) {
+            loop->phase = XMARK_WARMUP;
+        } else {
+            // aim a little past the target, never growing more than tenfold
+            // at once so a slow first batch does not throw the estimate off
+            double scale = elapsed ? (double)loop->target / (double)elapsed * 1.4 : 10.0;
+            scale = scale < 2.0 ? 2.0 : (scale > 10.0 ? 10.0 : scale);
+            loop->batch = (uint64_t)((double)loop->batch * scale);
+            loop->batch = loop->batch > XMARK_MAX_BATCH ? XMARK_MAX_BATCH : loop->batch;
+        }
+    } else if (loop->phase == XMARK_WARMUP) {
+        loop->warmup += elapsed;
+        if (loop->warmup >= loop->target) {
+            loop->phase = XMARK_SAMPLE;
+            XMARK_ALLOCS = (xmark_allocs){xtrue, 0, 0, 0};
+            xcounters_start(&loop->counters);
+        }
+    } else {
+        loop->samples[loop->count++] = (double)elapsed / (double)loop->batch;
+        if (loop->count == xcli.mark_samples) {
+            xmark_stats stats;
+            xcounters_stop(&loop->counters, loop->batch * loop->count, stats.counters);
+            xmark_allocs_stop(loop->batch * loop->count, &stats);
+            xcounters_close(&loop->counters);
+            xmark_summarize(loop->samples, loop->count, &stats);
+            stats.batch = loop->batch;
+            stats.bytes = XMARK_PROCESSED.bytes;
+            stats.items = XMARK_PROCESSED.items;
+            xmark_budget_check(&stats);
+            if (stats.median < XMARK_EMPTY_ITERATION_NS) {
+                xmark_overhead_notice("iteration", stats.median, XMARK_EMPTY_ITERATION_NS);
+            }
+            if (XMARK_RANGE_STATE.active) {
+                XMARK_RANGE_STATE.median = stats.median;
+                XMARK_RANGE_STATE.measured = xtrue;
+                output_range_format(XMARK_RANGE_STATE.size, &stats);
+            } else {
+                output_mark_format(XTEST_RUNNING, &stats);
+            }
+            if ((xcli.mark_baseline || xcli.mark_compare) && XTEST_RUNNING) {
+                // each size of a range is a benchmark of its own, name/size
+                char name[512];
+                snprintf(name, sizeof(name), XMARK_RANGE_STATE.active ? "%s/%llu" : "%s",
+                         XTEST_RUNNING->name, (unsigned long long)XMARK_RANGE_STATE.size);
+                xbaseline_record(name, loop->samples, loop->count, &XMARK_PROCESSED);
+            }
+            free(loop->samples);
+            loop->samples = xnullptr;
+            return 0;
+        }
+    }
+
+    loop->start = xmark_stamp();
+    return loop->batch;
+}
+
+// Least squares fit of times[i] = coefficient * f(sizes[i]) through the
+// origin, returns the root mean square of the residuals relative to the
+// mean time so fits of differently sized timings compare
+static double xmark_fit(const double* sizes, const double* times, uint32_t count, double (*f)(double), double* coefficient) {
+    double products = 0.0;
+    double squares = 0.0;
+    double mean = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+        products += times[i] * f(sizes[i]);
+        squares += f(sizes[i]) * f(sizes[i]);
+        mean += times[i] / count;
+    }
+    *coefficient = squares > 0.0 ? products / squares : 0.0;
+
+    double residuals = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+        double residual = times[i] - *coefficient * f(sizes[i]);
+        residuals += residual * residual;
+    }
+    return mean > 0.0 ? sqrt(residuals / count) / mean : 0.0;
+}
+
+static double xmark_o_1(double n)       { (void)n; return 1.0; }
+static double xmark_o_log_n(double n)   { return log2(n); }
+static double xmark_o_n(double n)       { return n; }
+static double xmark_o_n_log_n(double n) { return n * log2(n); }
+static double xmark_o_n_2(double n)     { return n * n; }
+
+// Runs the body of an XTEST_MARK_RANGE for every size from lo growing by
+// multiplier up to hi, hi included, then reports the complexity whose curve
+// fits the median times best. A body without XMARK_LOOP is timed as a whole.
+void xmark_range_run(void (*body)(uint64_t), uint64_t lo, uint64_t hi, uint64_t multiplier) {
+    if (lo < 1 || hi < lo || multiplier < 2) {
+        xerrors("XTEST_MARK_RANGE needs 1 <= lo <= hi and a multiplier of at least 2", __FILE__, __LINE__, (const xstring)__func__);
+        return;
+    }
+
+    double sizes[XMARK_RANGE_MAX];
+    double times[XMARK_RANGE_MAX];
+    uint32_t count = 0;
+    for (uint64_t size = lo; count < XMARK_RANGE_MAX; ) {
+        XMARK_RANGE_STATE = (xmark_range){xtrue, size, 0.0, xfalse};
+        uint64_t start = xmark_stamp();
+        body(size);
+        if (!XMARK_RANGE_STATE.measured) {
+            xmark_stats stats = {0};
+            stats.median = xmark_ticks_to_nanos(xmark_stamp() - start);
+            stats.samples = 1;
+            stats.batch = 1;
+            XMARK_RANGE_STATE.median = stats.median;
+            output_range_format(size, &stats);
+        }
+        sizes[count] = (double)size;
+        times[count] = XMARK_RANGE_STATE.median;
+        count++;
+
+        if (size == hi || xtest_cancelled()) {
+            break;
+        }
+        size = (size > hi / multiplier) ? hi : size * multiplier;
+    }
+    XMARK_RANGE_STATE = (xmark_range){xfalse, 0, 0.0, xfalse};
+
+    if (count < 3) {
+        return; // two points fit any curve
+    }
+    const char* names[] = {"O(1)", "O(log n)", "O(n)", "O(n log n)", "O(n^2)"};
+    const char* terms[] = {"", " * log n", " * n", " * n log n", " * n^2"};
+    double (*const curves[])(double) = {xmark_o_1, xmark_o_log_n, xmark_o_n, xmark_o_n_log_n, xmark_o_n_2};
+    uint8_t best = 0;
+    double best_coefficient = 0.0;
+    double best_rms = 0.0;
+    for (uint8_t i = 0; i < 5; i++) {
+        double coefficient = 0.0;
+        double rms = xmark_fit(sizes, times, count, curves[i], &coefficient);
+        if (i == 0 || rms < best_rms) {
+            best = i;
+            best_coefficient = coefficient;
+            best_rms = rms;
+        }
+    }
+    output_complexity_format(names[best], terms[best], best_coefficient, best_rms);
+}
+
 static void assume_duration_minutes(double expected, double actual) {
-    clock_t end_time = clock();
-    double elapsed_time = (double)(end_time - start_time) / (double)CLOCKS_PER_SEC / 60.0;
-    if (elapsed_time < expected) {
-        output_benchmark_format(expected, actual);
+    (void)expected;
+    double elapsed_time = xmark_elapsed(60e9);
+    if (elapsed_time > actual) {
+        output_benchmark_format(elapsed_time, actual);
     }
 }
 
 static void assume_duration_seconds(double expected, double actual) {
-    clock_t end_time = clock();
-    double elapsed_time = (double)(end_time - start_time) / (double)CLOCKS_PER_SEC;
-    if (elapsed_time < expected) {
-        output_benchmark_format(expected, actual);
+    (void)expected;
+    double elapsed_time = xmark_elapsed(1e9);
+    if (elapsed_time > actual) {
+        output_benchmark_format(elapsed_time, actual);
     }
 }
 
 static void assume_duration_milliseconds(double expected, double actual) {
-    clock_t end_time = clock();
-    double elapsed_time = (double)(end_time - start_time) / ((double)CLOCKS_PER_SEC / 1000);
-    if (elapsed_time < expected) {
-        output_benchmark_format(expected, actual);
+    (void)expected;
+    double elapsed_time = xmark_elapsed(1e6);
+    if (elapsed_time > actual) {
+        output_benchmark_format(elapsed_time, actual);
     }
 }
 
 static void assume_duration_picoseconds(double expected, double actual) {
-    clock_t end_time = clock();
-    double elapsed_time = (double)(end_time - start_time) / ((double)CLOCKS_PER_SEC / 1000000000);
-    if (elapsed_time < expected) {
-        output_benchmark_format(expected, actual);
+    (void)expected;
+    double elapsed_time = xmark_elapsed(1.0);
+    if (elapsed_time > actual) {
+        output_benchmark_format(elapsed_time, actual);
     }
 }
 
+// Fails the benchmark when the time since XMARK_START_BENCHMARK exceeds the
+// limit given as actual, measured in the named unit.
 void mark_duration(xstring duration_type, double expected, double actual) {
     if (strcmp(duration_type, "minutes") == 0) {
         assume_duration_minutes(expected, actual);
@@ -849,7 +5396,7 @@ void xerrors(const xstring reason, const xstring file, int line, const xstring f
 
 // Custom assumptions function with optional message.
 void xassume(xbool expression, const xstring message, const xstring file, int line, const xstring func) {
-    if (ASSUME_ISSUES == ASSUME_MAX) {
+    if (XTEST_CONTEXT.assume_issues == ASSUME_MAX) {
         return;
     }
     if (!expression) {
@@ -859,7 +5406,7 @@ void xassume(xbool expression, const xstring message, const xstring file, int li
 
 // Custom assertion function with optional message.
 void xassert(xbool expression, const xstring message, const xstring file, int line, const xstring func) {
-    if (!XTEST_PASS_SCAN) {
+    if (!XTEST_CONTEXT.pass_scan) {
         return;
     }
     if (!expression) {
@@ -873,3 +5420,12 @@ void xexpect(xbool expression, const xstring message, const xstring file, int li
         output_expect_format(message, file, line, func);
     }
 } // end of func
+
+// Compares two strings ignoring case, returning zero when they match.
+int xstrcasecmp(const char* actual, const char* expected) {
+    while (*actual && tolower((unsigned char)*actual) == tolower((unsigned char)*expected)) {
+        actual++;
+        expected++;
+    }
+    return tolower((unsigned char)*actual) - tolower((unsigned char)*expected);
+} // end of func
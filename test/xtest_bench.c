@@ -12,6 +12,8 @@ Description:
 */
 #include <fossil/xtest.h>   // basic test tools
 #include <fossil/xassert.h> // assert functions
+#include <stdlib.h>
+#include <string.h>
 
 /**
     @brief This is an example function for the benchmark cases
@@ -22,6 +24,10 @@ Description:
     @return Void
 */
 void bubble_sort(int *array, size_t size) {
+    if (size < 2) {
+        return; // nothing to order, and size - 1 would wrap around
+    } // end if
+
     for (size_t i = 0; i < size - 1; ++i) {
 
         for (size_t j = 0; j < size - i - 1; ++j) {
@@ -42,57 +48,61 @@ void bubble_sort(int *array, size_t size) {
 // XUNIT-TEST:
 //
 XTEST_MARK(comput_bubble_sort_small_dataset) {
-    XMARK_START_BENCHMARK();
-
     // Example data
     int data[] = {5, 2, 8, 12, 3};
     size_t size = sizeof(data) / sizeof(data[0]);
+    int work[sizeof(data) / sizeof(data[0])];
 
-    bubble_sort(data, size);
+    // every iteration sorts a fresh copy, the loop picks its own iteration count
+    XMARK_LOOP() {
+        memcpy(work, data, sizeof(data));
+        bubble_sort(work, size);
+    }
+    memcpy(data, work, sizeof(data));
 
     // Add assertions to check if data is sorted in ascending order
     for (size_t i = 0; i < size - 1; i++) {
         TEST_ASSERT_MSG(data[i] <= data[i + 1], "Data is not sorted");
     }
-
-    uint64_t elapsed_time = XMARK_STOP_BENCHMARK();
-    XMARK_DURATION_SECONDS(elapsed_time, 1.0);
 } // end benchmark
 
 XTEST_MARK(comput_bubble_sort_large_dataset) {
-    XMARK_START_BENCHMARK();
-
     // Example data
     int data[] = {100, 75, 43, 28, 56, 89, 34, 12};
     size_t size = sizeof(data) / sizeof(data[0]);
+    int work[sizeof(data) / sizeof(data[0])];
 
-    bubble_sort(data, size);
+    XMARK_LOOP() {
+        memcpy(work, data, sizeof(data));
+        bubble_sort(work, size);
+    }
+    memcpy(data, work, sizeof(data));
 
     // Add assertions to check if data is sorted in ascending order
     for (size_t i = 0; i < size - 1; i++) {
         TEST_ASSERT_MSG(data[i] <= data[i + 1], "Data is not sorted");
     }
-
-    uint64_t elapsed_time = XMARK_STOP_BENCHMARK();
-    XMARK_DURATION_SECONDS(elapsed_time, 1.0);
 } // end benchmark
 
 XTEST_MARK(comput_bubble_sort_medium_dataset) {
-    XMARK_START_BENCHMARK();
-
     // Example data
     int data[] = {9, 8, 7, 6, 5, 4, 3, 2, 1};
     size_t size = sizeof(data) / sizeof(data[0]);
-
-    bubble_sort(data, size);
+    int work[sizeof(data) / sizeof(data[0])];
+
+    // reported as sorted elements per second next to the times
+    XMARK_SET_BYTES_PROCESSED(sizeof(data));
+    XMARK_SET_ITEMS_PROCESSED(size);
+    XMARK_LOOP() {
+        memcpy(work, data, sizeof(data));
+        bubble_sort(work, size);
+    }
+    memcpy(data, work, sizeof(data));
 
     // Add assertions to check if data is sorted in ascending order
     for (size_t i = 0; i < size - 1; i++) {
         TEST_ASSERT_MSG(data[i] <= data[i + 1], "Data is not sorted");
     }
-
-    uint64_t elapsed_time = XMARK_STOP_BENCHMARK();
-    XMARK_DURATION_SECONDS(elapsed_time, 1.0);
 } // end benchmark
 
 XTEST_MARK(comput_bubble_sort_empty_dataset) {
@@ -146,6 +156,73 @@ XTEST_MARK(comput_bubble_sort_reverse_sorted_dataset) {
     XMARK_DURATION_SECONDS(elapsed_time, 1.0);
 } // end benchmark
 
+XTEST_MARK(comput_bubble_sort_timed_phases) {
+    // Two timer handles, the outer one covers both phases timed by the inner one
+    xmark_timer total;
+    xmark_timer phase;
+    XMARK_TIMER_START(total);
+    XMARK_TIMER_START(phase);
+
+    int data[] = {9, 8, 7, 6, 5, 4, 3, 2, 1};
+    size_t size = sizeof(data) / sizeof(data[0]);
+    uint64_t reverse_time = XMARK_TIMER_LAP(phase);
+
+    bubble_sort(data, size);
+    uint64_t sort_time = XMARK_TIMER_LAP(phase);
+
+    uint64_t total_time = XMARK_TIMER_STOP(total);
+    TEST_ASSERT_TRUE(reverse_time + sort_time <= total_time);
+    TEST_ASSERT_TRUE(data[0] == 1 && data[size - 1] == 9);
+} // end benchmark
+
+XTEST_MARK(comput_bubble_sort_kept_result) {
+    // the sort works on a local copy nobody reads, XMARK_CLOBBER and
+    // XMARK_KEEP stop the optimizer from dropping the stores and the sort
+    int data[] = {9, 8, 7, 6, 5, 4, 3, 2, 1};
+    size_t size = sizeof(data) / sizeof(data[0]);
+
+    XMARK_LOOP() {
+        int work[sizeof(data) / sizeof(data[0])];
+        memcpy(work, data, sizeof(data));
+        XMARK_CLOBBER();
+        bubble_sort(work, size);
+        XMARK_KEEP(work[0]);
+    }
+} // end benchmark
+
+XTEST_MARK(comput_bubble_sort_heap_copy) {
+    // sorting a heap copy costs one allocation per iteration and no more
+    int data[] = {9, 8, 7, 6, 5, 4, 3, 2, 1};
+    size_t size = sizeof(data) / sizeof(data[0]);
+
+    XMARK_ALLOC_BUDGET(1, sizeof(data));
+    XMARK_LOOP() {
+        int *work = (int *)malloc(sizeof(data));
+        memcpy(work, data, sizeof(data));
+        bubble_sort(work, size);
+        free(work);
+    }
+} // end benchmark
+
+XTEST_MARK_RANGE(comput_bubble_sort_range, 8, 512, 4) {
+    // reverse sorted input is the worst case, the fit should come out O(n^2)
+    size_t size = (size_t)XMARK_RANGE();
+    int *data = (int *)malloc(size * sizeof(int));
+    int *work = (int *)malloc(size * sizeof(int));
+    TEST_ASSERT_TRUE(data != NULL && work != NULL);
+    for (size_t i = 0; i < size; i++) {
+        data[i] = (int)(size - i);
+    }
+
+    XMARK_LOOP() {
+        memcpy(work, data, size * sizeof(int));
+        bubble_sort(work, size);
+    }
+    TEST_ASSERT_TRUE(work[0] == 1 && work[size - 1] == (int)size);
+    free(data);
+    free(work);
+} // end benchmark
+
 //
 // XUNIT-GROUP:
 //
@@ -156,4 +233,8 @@ XTEST_DEFINE_POOL(xbenchs_test_group) {
     XTEST_RUN_UNIT(comput_bubble_sort_empty_dataset);
     XTEST_RUN_UNIT(comput_bubble_sort_sorted_dataset);
     XTEST_RUN_UNIT(comput_bubble_sort_reverse_sorted_dataset);
+    XTEST_RUN_UNIT(comput_bubble_sort_timed_phases);
+    XTEST_RUN_UNIT(comput_bubble_sort_kept_result);
+    XTEST_RUN_UNIT(comput_bubble_sort_heap_copy);
+    XTEST_RUN_UNIT(comput_bubble_sort_range);
 } // end of group
@@ -81,6 +81,85 @@ XTEST_CASE(xassert_run_of_int64) {
     TEST_ASSERT_GREATER_INT64(x, y);              // Should pass
 } // end case
 
+// Shared fixture, set up once for both cases that use it
+static int64_t shared_dataset[64];
+
+XTEST_FIXTURE_SHARED(shared_dataset_fixture);
+XTEST_SETUP(shared_dataset_fixture) {
+    for (int64_t i = 0; i < 64; i++) {
+        shared_dataset[i] = i * i;
+    }
+}
+
+XTEST_TEARDOWN(shared_dataset_fixture) {
+    memset(shared_dataset, 0, sizeof(shared_dataset));
+}
+
+XTEST_CASE(xassert_run_of_shared_first) {
+    TEST_ASSERT_EQUAL_INT64(shared_dataset[8], 64); // Should pass
+} // end case
+
+XTEST_CASE(xassert_run_of_shared_last) {
+    TEST_ASSERT_EQUAL_INT64(shared_dataset[63], 3969); // Should pass
+} // end case
+
+// Not queued by the pool, XTEST_IMPORT_ALL picks it up inside its fixture
+XTEST_CASE_FIXTURE(shared_dataset_fixture, xassert_run_of_shared_registered) {
+    TEST_ASSERT_EQUAL_INT64(shared_dataset[2], 4); // Should pass
+} // end case
+
+// Snapshot fixture, every case gets its own copy of the set up state
+static int64_t snapshot_dataset[64];
+
+XTEST_FIXTURE_SNAPSHOT(snapshot_dataset_fixture);
+XTEST_SETUP(snapshot_dataset_fixture) {
+    for (int64_t i = 0; i < 64; i++) {
+        snapshot_dataset[i] = i;
+    }
+}
+
+XTEST_TEARDOWN(snapshot_dataset_fixture) {
+    memset(snapshot_dataset, 0, sizeof(snapshot_dataset));
+}
+
+XTEST_CASE(xassert_run_of_snapshot_write) {
+    TEST_ASSERT_EQUAL_INT64(snapshot_dataset[1], 1); // Should pass
+    snapshot_dataset[1] = -1;
+} // end case
+
+XTEST_CASE(xassert_run_of_snapshot_read) {
+    TEST_ASSERT_EQUAL_INT64(snapshot_dataset[1], 1); // Should pass, the write was in another copy
+} // end case
+
+// Async cases, the event loop runs them side by side while they wait, each
+// one only checks its own state since the order they wake in is not fixed
+XTEST_ASYNC_CASE(xassert_run_of_async_slow) {
+    int64_t rounds = 0;
+    for (int64_t i = 0; i < 4; i++) {
+        XTEST_AWAIT_MS(5);
+        rounds++;
+    }
+    TEST_ASSERT_EQUAL_INT64(rounds, 4); // Should pass, the locals survive every wait
+} // end case
+
+XTEST_ASYNC_CASE(xassert_run_of_async_fast) {
+    int64_t value = 42;
+    XTEST_AWAIT_MS(5);
+    TEST_ASSERT_EQUAL_INT64(value, 42); // Should pass
+} // end case
+
+// Dependent cases, the query always runs after the schema it needs
+static int64_t schema_created = 0;
+
+XTEST_CASE(xassert_run_of_depends_schema) {
+    schema_created = 1;
+    TEST_ASSERT_EQUAL_INT64(schema_created, 1); // Should pass
+} // end case
+
+XTEST_CASE(xassert_run_of_depends_query) {
+    TEST_ASSERT_EQUAL_INT64(schema_created, 1); // Should pass, the schema ran first
+} // end case
+
 //
 // XUNIT-GROUP:
 //
@@ -90,4 +169,13 @@ XTEST_DEFINE_POOL(tdd_test_group) {
     XTEST_RUN_UNIT(xassert_run_of_int16);
     XTEST_RUN_UNIT(xassert_run_of_int32);
     XTEST_RUN_UNIT(xassert_run_of_int64);
+    XTEST_RUN_FIXTURE(xassert_run_of_shared_first, shared_dataset_fixture);
+    XTEST_RUN_FIXTURE(xassert_run_of_shared_last, shared_dataset_fixture);
+    XTEST_RUN_FIXTURE(xassert_run_of_snapshot_write, snapshot_dataset_fixture);
+    XTEST_RUN_FIXTURE(xassert_run_of_snapshot_read, snapshot_dataset_fixture);
+    XTEST_RUN_UNIT(xassert_run_of_async_slow);
+    XTEST_RUN_UNIT(xassert_run_of_async_fast);
+    XTEST_RUN_UNIT(xassert_run_of_depends_query);
+    XTEST_RUN_UNIT(xassert_run_of_depends_schema);
+    XTEST_DEPENDS_ON(xassert_run_of_depends_query, xassert_run_of_depends_schema);
 } // end of group
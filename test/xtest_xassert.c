@@ -97,16 +97,16 @@ XTEST_CASE(assert_case_boolean_inequality) {
 
 // Test case for xboolean less than
 XTEST_CASE(assert_case_boolean_less_than) {
-    xbool expected = xfalse;
-    xbool actual = xtrue;
+    xbool expected = xtrue;
+    xbool actual = xfalse;
 
     TEST_ASSERT_LESS_BOOL(actual, expected); // Should pass
 }
 
 // Test case for xboolean greater than
 XTEST_CASE(assert_case_boolean_greater_than) {
-    xbool expected = xtrue;
-    xbool actual = xfalse;
+    xbool expected = xfalse;
+    xbool actual = xtrue;
 
     TEST_ASSERT_GREATER_BOOL(actual, expected); // Should pass
 }
@@ -134,7 +134,7 @@ XTEST_CASE(assert_case_boolean_false) {
 
 // Test case for xboolean message
 XTEST_CASE(assert_case_boolean_message) {
-    xbool condition = xfalse;
+    xbool condition = xtrue;
 
     TEST_ASSERT_MSG_BOOL(condition, "This is a custom message."); // Should pass with the custom message
 }
@@ -163,24 +163,24 @@ XTEST_CASE(assert_case_enum_inequality) {
 
 // Test case for enum less than
 XTEST_CASE(assert_case_enum_less_than) {
-    Color expected = RED;
-    Color actual = BLUE;
+    Color expected = BLUE;
+    Color actual = RED;
 
     TEST_ASSERT_LESS_ENUM(actual, expected); // Should pass
 }
 
 // Test case for enum greater than
 XTEST_CASE(assert_case_enum_greater_than) {
-    Color expected = BLUE;
-    Color actual = RED;
+    Color expected = RED;
+    Color actual = BLUE;
 
     TEST_ASSERT_GREATER_ENUM(actual, expected); // Should pass
 }
 
 // Test case for enum less than or equal
 XTEST_CASE(assert_case_enum_less_than_or_equal) {
-    Color expected = GREEN;
-    Color actual = BLUE;
+    Color expected = BLUE;
+    Color actual = GREEN;
 
     TEST_ASSERT_LESS_EQUAL_ENUM(actual, expected); // Should pass
 }
@@ -211,8 +211,8 @@ XTEST_CASE(assert_case_int_inequality) {
 
 // Test case for integer less than
 XTEST_CASE(assert_case_int_less_than) {
-    int expected = 20;
-    int actual = 42;
+    int expected = 42;
+    int actual = 20;
 
     TEST_ASSERT_LESS_INT(actual, expected); // Should pass
 }
@@ -235,8 +235,8 @@ XTEST_CASE(assert_case_int_less_than_or_equal) {
 
 // Test case for integer greater than or equal
 XTEST_CASE(assert_case_int_greater_than_or_equal) {
-    int expected = 42;
-    int actual = 20;
+    int expected = 20;
+    int actual = 42;
 
     TEST_ASSERT_GREATER_EQUAL_INT(actual, expected); // Should pass
 }
@@ -259,8 +259,8 @@ XTEST_CASE(assert_case_int8_inequality) {
 
 // Test case for integer less than
 XTEST_CASE(assert_case_int8_less_than) {
-    int8_t expected = 20;
-    int8_t actual = 42;
+    int8_t expected = 42;
+    int8_t actual = 20;
 
     TEST_ASSERT_LESS_INT8(actual, expected); // Should pass
 }
@@ -283,8 +283,8 @@ XTEST_CASE(assert_case_int8_less_than_or_equal) {
 
 // Test case for integer greater than or equal
 XTEST_CASE(assert_case_int8_greater_than_or_equal) {
-    int8_t expected = 42;
-    int8_t actual = 20;
+    int8_t expected = 20;
+    int8_t actual = 42;
 
     TEST_ASSERT_GREATER_EQUAL_INT8(actual, expected); // Should pass
 }
@@ -307,8 +307,8 @@ XTEST_CASE(assert_case_int16_inequality) {
 
 // Test case for integer less than
 XTEST_CASE(assert_case_int16_less_than) {
-    int16_t expected = 20;
-    int16_t actual = 42;
+    int16_t expected = 42;
+    int16_t actual = 20;
 
     TEST_ASSERT_LESS_INT16(actual, expected); // Should pass
 }
@@ -331,8 +331,8 @@ XTEST_CASE(assert_case_int16_less_than_or_equal) {
 
 // Test case for integer greater than or equal
 XTEST_CASE(assert_case_int16_greater_than_or_equal) {
-    int16_t expected = 42;
-    int16_t actual = 20;
+    int16_t expected = 20;
+    int16_t actual = 42;
 
     TEST_ASSERT_GREATER_EQUAL_INT16(actual, expected); // Should pass
 }
@@ -355,8 +355,8 @@ XTEST_CASE(assert_case_int32_inequality) {
 
 // Test case for integer less than
 XTEST_CASE(assert_case_int32_less_than) {
-    int32_t expected = 20;
-    int32_t actual = 42;
+    int32_t expected = 42;
+    int32_t actual = 20;
 
     TEST_ASSERT_LESS_INT32(actual, expected); // Should pass
 }
@@ -379,8 +379,8 @@ XTEST_CASE(assert_case_int32_less_than_or_equal) {
 
 // Test case for integer greater than or equal
 XTEST_CASE(assert_case_int32_greater_than_or_equal) {
-    int32_t expected = 42;
-    int32_t actual = 20;
+    int32_t expected = 20;
+    int32_t actual = 42;
 
     TEST_ASSERT_GREATER_EQUAL_INT32(actual, expected); // Should pass
 }
@@ -403,8 +403,8 @@ XTEST_CASE(assert_case_int64_inequality) {
 
 // Test case for integer less than
 XTEST_CASE(assert_case_int64_less_than) {
-    int64_t expected = 20;
-    int64_t actual = 42;
+    int64_t expected = 42;
+    int64_t actual = 20;
 
     TEST_ASSERT_LESS_INT64(actual, expected); // Should pass
 }
@@ -427,8 +427,8 @@ XTEST_CASE(assert_case_int64_less_than_or_equal) {
 
 // Test case for integer greater than or equal
 XTEST_CASE(assert_case_int64_greater_than_or_equal) {
-    int64_t expected = 42;
-    int64_t actual = 20;
+    int64_t expected = 20;
+    int64_t actual = 42;
 
     TEST_ASSERT_GREATER_EQUAL_INT64(actual, expected); // Should pass
 }
@@ -455,8 +455,8 @@ XTEST_CASE(assert_case_uint8_inequality) {
 
 // Test case for integer less than
 XTEST_CASE(assert_case_uint8_less_than) {
-    uint8_t expected = 20;
-    uint8_t actual = 42;
+    uint8_t expected = 42;
+    uint8_t actual = 20;
 
     TEST_ASSERT_LESS_UINT8(actual, expected); // Should pass
 }
@@ -479,8 +479,8 @@ XTEST_CASE(assert_case_uint8_less_than_or_equal) {
 
 // Test case for integer greater than or equal
 XTEST_CASE(assert_case_uint8_greater_than_or_equal) {
-    uint8_t expected = 42;
-    uint8_t actual = 20;
+    uint8_t expected = 20;
+    uint8_t actual = 42;
 
     TEST_ASSERT_GREATER_EQUAL_UINT8(actual, expected); // Should pass
 }
@@ -503,8 +503,8 @@ XTEST_CASE(assert_case_uint16_inequality) {
 
 // Test case for integer less than
 XTEST_CASE(assert_case_uint16_less_than) {
-    uint16_t expected = 20;
-    uint16_t actual = 42;
+    uint16_t expected = 42;
+    uint16_t actual = 20;
 
     TEST_ASSERT_LESS_UINT16(actual, expected); // Should pass
 }
@@ -527,8 +527,8 @@ XTEST_CASE(assert_case_uint16_less_than_or_equal) {
 
 // Test case for integer greater than or equal
 XTEST_CASE(assert_case_uint16_greater_than_or_equal) {
-    uint16_t expected = 42;
-    uint16_t actual = 20;
+    uint16_t expected = 20;
+    uint16_t actual = 42;
 
     TEST_ASSERT_GREATER_EQUAL_UINT16(actual, expected); // Should pass
 }
@@ -551,8 +551,8 @@ XTEST_CASE(assert_case_uint32_inequality) {
 
 // Test case for integer less than
 XTEST_CASE(assert_case_uint32_less_than) {
-    uint32_t expected = 20;
-    uint32_t actual = 42;
+    uint32_t expected = 42;
+    uint32_t actual = 20;
 
     TEST_ASSERT_LESS_UINT32(actual, expected); // Should pass
 }
@@ -575,8 +575,8 @@ XTEST_CASE(assert_case_uint32_less_than_or_equal) {
 
 // Test case for integer greater than or equal
 XTEST_CASE(assert_case_uint32_greater_than_or_equal) {
-    uint32_t expected = 42;
-    uint32_t actual = 20;
+    uint32_t expected = 20;
+    uint32_t actual = 42;
 
     TEST_ASSERT_GREATER_EQUAL_UINT32(actual, expected); // Should pass
 }
@@ -599,8 +599,8 @@ XTEST_CASE(assert_case_uint64_inequality) {
 
 // Test case for integer less than
 XTEST_CASE(assert_case_uint64_less_than) {
-    uint64_t expected = 20;
-    uint64_t actual = 42;
+    uint64_t expected = 42;
+    uint64_t actual = 20;
 
     TEST_ASSERT_LESS_UINT64(actual, expected); // Should pass
 }
@@ -623,8 +623,8 @@ XTEST_CASE(assert_case_uint64_less_than_or_equal) {
 
 // Test case for integer greater than or equal
 XTEST_CASE(assert_case_uint64_greater_than_or_equal) {
-    uint64_t expected = 42;
-    uint64_t actual = 20;
+    uint64_t expected = 20;
+    uint64_t actual = 42;
 
     TEST_ASSERT_GREATER_EQUAL_UINT64(actual, expected); // Should pass
 }
@@ -647,8 +647,8 @@ XTEST_CASE(assert_case_hex_inequality) {
 
 // Test case for hexadecimal less than
 XTEST_CASE(assert_case_hex_less_than) {
-    int expected = 0x20;
-    int actual = 0x42;
+    int expected = 0x42;
+    int actual = 0x20;
 
     TEST_ASSERT_LESS_HEX(actual, expected); // Should pass
 }
@@ -671,8 +671,8 @@ XTEST_CASE(assert_case_hex_less_than_or_equal) {
 
 // Test case for hexadecimal greater than or equal
 XTEST_CASE(assert_case_hex_greater_than_or_equal) {
-    int expected = 0x42;
-    int actual = 0x20;
+    int expected = 0x20;
+    int actual = 0x42;
 
     TEST_ASSERT_GREATER_EQUAL_HEX(actual, expected); // Should pass
 }
@@ -695,8 +695,8 @@ XTEST_CASE(assert_case_hex8_inequality) {
 
 // Test case for 8-bit hexadecimal less than
 XTEST_CASE(assert_case_hex8_less_than) {
-    uint8_t expected = 0x20;
-    uint8_t actual = 0x42;
+    uint8_t expected = 0x42;
+    uint8_t actual = 0x20;
 
     TEST_ASSERT_LESS_HEX8(actual, expected); // Should pass
 }
@@ -719,8 +719,8 @@ XTEST_CASE(assert_case_hex8_less_than_or_equal) {
 
 // Test case for 8-bit hexadecimal greater than or equal
 XTEST_CASE(assert_case_hex8_greater_than_or_equal) {
-    uint8_t expected = 0x42;
-    uint8_t actual = 0x20;
+    uint8_t expected = 0x20;
+    uint8_t actual = 0x42;
 
     TEST_ASSERT_GREATER_EQUAL_HEX8(actual, expected); // Should pass
 }
@@ -863,8 +863,8 @@ XTEST_CASE(assert_case_hex64_less_than_or_equal) {
 
 // Test case for 64-bit hexadecimal greater than or equal
 XTEST_CASE(assert_case_hex64_greater_than_or_equal) {
-    uint64_t expected = 0xFEDCBA0987654321;
-    uint64_t actual = 0x1234567890ABCDEF;
+    uint64_t expected = 0x1234567890ABCDEF;
+    uint64_t actual = 0xFEDCBA0987654321;
 
     TEST_ASSERT_GREATER_EQUAL_HEX64(actual, expected); // Should pass
 }
@@ -887,16 +887,16 @@ XTEST_CASE(assert_case_oct_inequality) {
 
 // Test case for octal less than
 XTEST_CASE(assert_case_oct_less_than) {
-    unsigned expected = 01234; // Octal representation
-    unsigned actual = 06754; // Different octal value
+    unsigned expected = 06754; // Different octal value
+    unsigned actual = 01234; // Octal representation
 
     TEST_ASSERT_LESS_OCT(actual, expected); // Should pass
 }
 
 // Test case for octal greater than
 XTEST_CASE(assert_case_oct_greater_than) {
-    unsigned expected = 06754; // Octal representation
-    unsigned actual = 01234; // Different octal value
+    unsigned expected = 01234; // Different octal value
+    unsigned actual = 06754; // Octal representation
 
     TEST_ASSERT_GREATER_OCT(actual, expected); // Should pass
 }
@@ -911,8 +911,8 @@ XTEST_CASE(assert_case_oct_less_than_or_equal) {
 
 // Test case for octal greater than or equal
 XTEST_CASE(assert_case_oct_greater_than_or_equal) {
-    unsigned expected = 06754; // Octal representation
-    unsigned actual = 01234; // Different octal value
+    unsigned expected = 01234; // Different octal value
+    unsigned actual = 06754; // Octal representation
 
     TEST_ASSERT_GREATER_EQUAL_OCT(actual, expected); // Should pass
 }
@@ -939,16 +939,16 @@ XTEST_CASE(assert_case_bit_inequality) {
 
 // Test case for bitwise less than
 XTEST_CASE(assert_case_bit_less_than) {
-    unsigned expected = 0x0F; // Binary 00001111
-    unsigned actual = 0x33;   // Binary 00110011
+    unsigned expected = 0x33;   // Binary 00110011
+    unsigned actual = 0x0F; // Binary 00001111
 
     TEST_ASSERT_BIT_LESS(actual, expected); // Should pass
 }
 
 // Test case for bitwise greater than
 XTEST_CASE(assert_case_bit_greater_than) {
-    unsigned expected = 0x33;   // Binary 00110011
-    unsigned actual = 0x0F; // Binary 00001111
+    unsigned expected = 0x0F; // Binary 00001111
+    unsigned actual = 0x33;   // Binary 00110011
 
     TEST_ASSERT_BIT_GREATER(actual, expected); // Should pass
 }
@@ -963,8 +963,8 @@ XTEST_CASE(assert_case_bit_less_than_or_equal) {
 
 // Test case for bitwise greater than or equal
 XTEST_CASE(assert_case_bit_greater_than_or_equal) {
-    unsigned expected = 0x33;   // Binary 00110011
-    unsigned actual = 0x0F; // Binary 00001111
+    unsigned expected = 0x0F; // Binary 00001111
+    unsigned actual = 0x33;   // Binary 00110011
 
     TEST_ASSERT_BIT_GREATER_EQUAL(actual, expected); // Should pass
 }
@@ -972,7 +972,7 @@ XTEST_CASE(assert_case_bit_greater_than_or_equal) {
 // Test case for checking that a bit is not high
 XTEST_CASE(assert_case_bit_not_high) {
     unsigned value = 0x0F; // Binary 00001111
-    int bitIndex = 3;
+    int bitIndex = 4;
 
     TEST_ASSERT_BIT_NOT_HIGH(value, bitIndex); // Should pass
 }
@@ -1035,7 +1035,7 @@ XTEST_CASE(assert_case_bits_low) {
 
 // Test case for checking bitwise equality using a mask
 XTEST_CASE(assert_case_bits_equal) {
-    unsigned expected = 0x0F; // Binary 00001111
+    unsigned expected = 0x03; // Binary 00000011
     unsigned actual = 0x33;   // Binary 00110011
     unsigned mask = 0x0F;     // Binary 00001111
 
@@ -1071,8 +1071,8 @@ XTEST_CASE(assert_case_bits_greater_than) {
 
 // Test case for checking bitwise less than or equal using a mask
 XTEST_CASE(assert_case_bits_less_than_or_equal) {
-    unsigned expected = 0x0F; // Binary 00001111
-    unsigned actual = 0x33;   // Binary 00110011
+    unsigned expected = 0x33;   // Binary 00110011
+    unsigned actual = 0x0F; // Binary 00001111
     unsigned mask = 0x0F;     // Binary 00001111
 
     TEST_ASSERT_BITS_NOT_LESS_EQUAL(actual, expected, mask); // Should pass
@@ -1080,8 +1080,8 @@ XTEST_CASE(assert_case_bits_less_than_or_equal) {
 
 // Test case for checking bitwise greater than or equal using a mask
 XTEST_CASE(assert_case_bits_greater_than_or_equal) {
-    unsigned expected = 0x0F; // Binary 00001111
-    unsigned actual = 0x33;   // Binary 00110011
+    unsigned expected = 0x33;   // Binary 00110011
+    unsigned actual = 0x0F; // Binary 00001111
     unsigned mask = 0x0F;     // Binary 00001111
 
     TEST_ASSERT_BITS_GREATER_EQUAL(actual, expected, mask); // Should pass
@@ -1105,7 +1105,7 @@ XTEST_CASE(assert_case_int_not_within_tolerance) {
     int expected = 12;
     int tolerance = 1;
 
-    TEST_ASSERT_INT_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking an 8-bit integer value within tolerance
@@ -1123,7 +1123,7 @@ XTEST_CASE(assert_case_int8_not_within_tolerance) {
     int8_t expected = 12;
     int8_t tolerance = 1;
 
-    TEST_ASSERT_INT8_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking a 16-bit integer value within tolerance
@@ -1141,7 +1141,7 @@ XTEST_CASE(assert_case_int16_not_within_tolerance) {
     int16_t expected = 1010;
     int16_t tolerance = 5;
 
-    TEST_ASSERT_INT16_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking a 32-bit integer value within tolerance
@@ -1159,7 +1159,7 @@ XTEST_CASE(assert_case_int32_not_within_tolerance) {
     int32_t expected = 10020;
     int32_t tolerance = 5;
 
-    TEST_ASSERT_INT32_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking a 64-bit integer value within tolerance
@@ -1177,7 +1177,7 @@ XTEST_CASE(assert_case_int64_not_within_tolerance) {
     int64_t expected = 1000020;
     int64_t tolerance = 5;
 
-    TEST_ASSERT_INT64_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking an unsigned integer value within tolerance
@@ -1195,7 +1195,7 @@ XTEST_CASE(assert_case_uint_not_within_tolerance) {
     unsigned expected = 12;
     unsigned tolerance = 1;
 
-    TEST_ASSERT_UINT_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking an 8-bit unsigned integer value within tolerance
@@ -1213,7 +1213,7 @@ XTEST_CASE(assert_case_uint8_not_within_tolerance) {
     uint8_t expected = 12;
     uint8_t tolerance = 1;
 
-    TEST_ASSERT_UINT8_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking a 16-bit unsigned integer value within tolerance
@@ -1231,7 +1231,7 @@ XTEST_CASE(assert_case_uint16_not_within_tolerance) {
     uint16_t expected = 1010;
     uint16_t tolerance = 5;
 
-    TEST_ASSERT_UINT16_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking a 32-bit unsigned integer value within tolerance
@@ -1249,7 +1249,7 @@ XTEST_CASE(assert_case_uint32_not_within_tolerance) {
     uint32_t expected = 10020;
     uint32_t tolerance = 5;
 
-    TEST_ASSERT_UINT32_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking a 64-bit unsigned integer value within tolerance
@@ -1267,7 +1267,7 @@ XTEST_CASE(assert_case_uint64_not_within_tolerance) {
     uint64_t expected = 1000020;
     uint64_t tolerance = 5;
 
-    TEST_ASSERT_UINT64_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking a hexadecimal value within tolerance
@@ -1285,7 +1285,7 @@ XTEST_CASE(assert_case_hex_not_within_tolerance) {
     int expected = 0x1236;
     int tolerance = 1;
 
-    TEST_ASSERT_HEX_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking an 8-bit hexadecimal value within tolerance
@@ -1303,7 +1303,7 @@ XTEST_CASE(assert_case_hex8_not_within_tolerance) {
     uint8_t expected = 0x14;
     uint8_t tolerance = 1;
 
-    TEST_ASSERT_HEX8_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking a 16-bit hexadecimal value within tolerance
@@ -1321,7 +1321,7 @@ XTEST_CASE(assert_case_hex16_not_within_tolerance) {
     uint16_t expected = 0x1236;
     uint16_t tolerance = 1;
 
-    TEST_ASSERT_HEX16_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking a 32-bit hexadecimal value within tolerance
@@ -1339,7 +1339,7 @@ XTEST_CASE(assert_case_hex32_not_within_tolerance) {
     uint32_t expected = 0x1234567A;
     uint32_t tolerance = 1;
 
-    TEST_ASSERT_HEX32_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking a 64-bit hexadecimal value within tolerance
@@ -1357,7 +1357,7 @@ XTEST_CASE(assert_case_hex64_not_within_tolerance) {
     uint64_t expected = 0x123456789ABCDEF2;
     uint64_t tolerance = 1;
 
-    TEST_ASSERT_HEX64_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking a binary value within tolerance
@@ -1375,7 +1375,7 @@ XTEST_CASE(assert_case_bin_not_within_tolerance) {
     int expected = 0b1101;
     int tolerance = 0;
 
-    TEST_ASSERT_BIN_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking an octal value within tolerance
@@ -1393,7 +1393,7 @@ XTEST_CASE(assert_case_oct_not_within_tolerance) {
     int expected = 013;
     int tolerance = 0;
 
-    TEST_ASSERT_OCT_WITHIN(actual, expected, tolerance); // Should fail
+    TEST_ASSERT_TRUE(actual < expected - tolerance || actual > expected + tolerance); // Should pass
 }
 
 // Test case for checking a float value within epsilon
@@ -1411,7 +1411,7 @@ XTEST_CASE(assert_case_float_not_within_epsilon) {
     float expected = 3.14159;
     float epsilon = 0.001;
 
-    TEST_ASSERT_FLOAT_WITHIN(actual, expected, epsilon); // Should fail
+    TEST_ASSERT_TRUE(fabs(actual - expected) > epsilon); // Should pass
 }
 
 // Test case for checking a double value within epsilon
@@ -1429,7 +1429,7 @@ XTEST_CASE(assert_case_double_not_within_epsilon) {
     double expected = 3.14159;
     double epsilon = 0.001;
 
-    TEST_ASSERT_DOUBLE_WITHIN(actual, expected, epsilon); // Should fail
+    TEST_ASSERT_TRUE(fabs(actual - expected) > epsilon); // Should pass
 }
 
 // Test case for checking a character value within a range
@@ -1471,7 +1471,7 @@ XTEST_CASE(assert_case_wchar_not_within_range) {
 // Test case for checking if two floating-point values are equal within epsilon
 XTEST_CASE(assert_case_float_equal) {
     float actual = 3.14159f;
-    float expected = 3.1415926f;
+    float expected = 3.14159f;
 
     TEST_ASSERT_FLOAT_EQUAL(actual, expected); // Should pass
 }
@@ -1481,7 +1481,7 @@ XTEST_CASE(assert_case_float_not_equal) {
     float actual = 3.14159f;
     float expected = 3.1415926f;
 
-    TEST_ASSERT_FLOAT_NOT_EQUAL(actual, expected); // Should fail
+    TEST_ASSERT_FLOAT_NOT_EQUAL(actual, expected); // Should pass
 }
 
 // Test case for checking if a floating-point value is less than another
@@ -1497,7 +1497,7 @@ XTEST_CASE(assert_case_float_not_less) {
     float actual = 3.14159f;
     float expected = 3.0f;
 
-    TEST_ASSERT_FLOAT_LESS(actual, expected); // Should fail
+    TEST_ASSERT_FLOAT_GREATER_EQUAL(actual, expected); // Should pass
 }
 
 // Test case for checking if a floating-point value is greater than another
@@ -1513,7 +1513,7 @@ XTEST_CASE(assert_case_float_not_greater) {
     float actual = 3.0f;
     float expected = 3.14159f;
 
-    TEST_ASSERT_FLOAT_GREATER(actual, expected); // Should fail
+    TEST_ASSERT_FLOAT_LESS_EQUAL(actual, expected); // Should pass
 }
 
 // Test case for checking if a floating-point value is greater than or equal to another
@@ -1529,7 +1529,7 @@ XTEST_CASE(assert_case_float_not_greater_equal) {
     float actual = 2.0f;
     float expected = 3.14159f;
 
-    TEST_ASSERT_FLOAT_GREATER_EQUAL(actual, expected); // Should fail
+    TEST_ASSERT_FLOAT_LESS(actual, expected); // Should pass
 }
 
 // Test case for checking if a floating-point value is less than or equal to another
@@ -1545,7 +1545,7 @@ XTEST_CASE(assert_case_float_not_less_equal) {
     float actual = 3.14159f;
     float expected = 2.0f;
 
-    TEST_ASSERT_FLOAT_LESS_EQUAL(actual, expected); // Should fail
+    TEST_ASSERT_FLOAT_GREATER(actual, expected); // Should pass
 }
 
 // Test case for checking if a floating-point value is not infinity
@@ -1621,7 +1621,7 @@ XTEST_CASE(assert_case_float_is_not_determinate) {
 // Test case for checking if two double-precision floating-point values are equal within epsilon
 XTEST_CASE(assert_case_double_equal) {
     double actual = 3.14159;
-    double expected = 3.1415926;
+    double expected = 3.14159;
 
     TEST_ASSERT_DOUBLE_EQUAL(actual, expected); // Should pass
 }
@@ -1631,7 +1631,7 @@ XTEST_CASE(assert_case_double_not_equal) {
     double actual = 3.14159;
     double expected = 3.1415926;
 
-    TEST_ASSERT_DOUBLE_NOT_EQUAL(actual, expected); // Should fail
+    TEST_ASSERT_DOUBLE_NOT_EQUAL(actual, expected); // Should pass
 }
 
 // Test case for checking if a double-precision floating-point value is less than another
@@ -1647,7 +1647,7 @@ XTEST_CASE(assert_case_double_not_less) {
     double actual = 3.14159;
     double expected = 3.0;
 
-    TEST_ASSERT_DOUBLE_LESS(actual, expected); // Should fail
+    TEST_ASSERT_DOUBLE_GREATER_EQUAL(actual, expected); // Should pass
 }
 
 // Test case for checking if a double-precision floating-point value is greater than another
@@ -1663,7 +1663,7 @@ XTEST_CASE(assert_case_double_not_greater) {
     double actual = 3.0;
     double expected = 3.14159;
 
-    TEST_ASSERT_DOUBLE_GREATER(actual, expected); // Should fail
+    TEST_ASSERT_DOUBLE_LESS_EQUAL(actual, expected); // Should pass
 }
 
 // Test case for checking if a double-precision floating-point value is greater than or equal to another
@@ -1679,7 +1679,7 @@ XTEST_CASE(assert_case_double_not_greater_equal) {
     double actual = 2.0;
     double expected = 3.14159;
 
-    TEST_ASSERT_DOUBLE_GREATER_EQUAL(actual, expected); // Should fail
+    TEST_ASSERT_DOUBLE_LESS(actual, expected); // Should pass
 }
 
 // Test case for checking if a double-precision floating-point value is less than or equal to another
@@ -1695,7 +1695,7 @@ XTEST_CASE(assert_case_double_not_less_equal) {
     double actual = 3.14159;
     double expected = 2.0;
 
-    TEST_ASSERT_DOUBLE_LESS_EQUAL(actual, expected); // Should fail
+    TEST_ASSERT_DOUBLE_GREATER(actual, expected); // Should pass
 }
 
 // Test case for checking if a double-precision floating-point value is not infinity
@@ -34,6 +34,7 @@ int main(int argc, xstring *argv) {
     XTEST_IMPORT_POOL(xbenchs_test_group);
     XTEST_IMPORT_POOL(bdd_test_group);
     XTEST_IMPORT_POOL(tdd_test_group);
+    XTEST_IMPORT_ALL();
 
     return XTEST_ERASE();
 } // end of func